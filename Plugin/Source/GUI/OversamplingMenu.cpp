@@ -2,7 +2,9 @@
 
 namespace
 {
-const StringArray latencyChangeParameters { "loss_onoff", "hyst_onoff", "comp_onoff" };
+const String sharedOSTag = "os_shared";
+const StringArray latencyChangeParameters { "loss_onoff", "hyst_onoff", "comp_onoff", sharedOSTag };
+constexpr int sharedOSItemID = 1000; // (well clear of the IDs used for the oversampling choices)
 }
 
 OversamplingMenu::OversamplingMenu (OversamplerType& osManager,
@@ -41,9 +43,32 @@ void OversamplingMenu::generateComboBoxMenu()
                 if (! menu->containsAnyActiveItems())
                     return;
 
+                addSharedOversamplingItem (*menu);
+
                 auto totalLatencyMs = ((double) processor.getLatencySamples() / processor.getSampleRate()) * 1000.0;
                 totalLatencyMs = totalLatencyMs < 0.025 ? 0.0 : totalLatencyMs;
                 menu->addSectionHeader ("Total Latency: " + juce::String (totalLatencyMs, 3) + " ms");
             }
         });
 }
+
+void OversamplingMenu::addSharedOversamplingItem (PopupMenu& menu)
+{
+    auto* sharedOSParam = vts.getParameter (sharedOSTag);
+    if (sharedOSParam == nullptr)
+        return;
+
+    // this is an on/off option rather than a list of choices, so it gets a ticked item of its own
+    menu.addSectionHeader ("Options");
+
+    PopupMenu::Item item;
+    item.itemID = sharedOSItemID;
+    item.text = sharedOSParam->getName (1024);
+    item.isTicked = sharedOSParam->getValue() > 0.5f;
+    item.action = [sharedOSParam, newValue = item.isTicked ? 0.0f : 1.0f] {
+        sharedOSParam->beginChangeGesture();
+        sharedOSParam->setValueNotifyingHost (newValue);
+        sharedOSParam->endChangeGesture();
+    };
+    menu.addItem (item);
+}
\ No newline at end of file
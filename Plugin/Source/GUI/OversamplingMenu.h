@@ -16,6 +16,8 @@ public:
     void generateComboBoxMenu() override;
 
 private:
+    void addSharedOversamplingItem (PopupMenu& menu);
+
     AudioProcessorValueTreeState& vts;
     const AudioProcessor& processor;
 
@@ -45,10 +45,14 @@ void SettingsButton::showSettingsMenu()
     PopupMenu menu;
 
     openGLMenu (menu, 100);
+    processingMenu (menu, 200);
 
     menu.addSeparator();
     menu.addItem ("View Source Code", [=] { URL ("https://github.com/jatinchowdhury18/AnalogTapeModel").launchInDefaultBrowser(); });
     menu.addItem ("Copy Diagnostic Info", [=] { copyDiagnosticInfo(); });
+#if CHOWTAPE_PROFILER
+    menu.addItem ("Copy DSP Profile", [=] { SystemClipboard::copyTextToClipboard (proc.getStageProfiler().getSummary()); });
+#endif
     menu.addItem ("View User Manual", [=] { URL ("https://chowdsp.com/manuals/ChowTapeManual.pdf").launchInDefaultBrowser(); });
 
     // get top level component that is big enough
@@ -92,6 +96,28 @@ void SettingsButton::openGLMenu (PopupMenu& menu, int itemID)
     menu.addItem (item);
 }
 
+void SettingsButton::processingMenu (PopupMenu& menu, int itemID)
+{
+    auto addSettingItem = [&] (SettingID settingID, const String& text) {
+        const auto isCurrentlyOn = pluginSettings->getProperty<bool> (settingID);
+
+        PopupMenu::Item item;
+        item.itemID = ++itemID;
+        item.text = text;
+        item.action = [=] { pluginSettings->setProperty (settingID, ! isCurrentlyOn); };
+        item.colour = isCurrentlyOn ? onColour : offColour;
+
+        menu.addItem (item);
+    };
+
+    addSettingItem (ChowtapeModelAudioProcessor::pipelinedID, "Pipelined Processing (+1 Block Latency)");
+    addSettingItem (ChowtapeModelAudioProcessor::sharedModulationID, "Share Wow/Flutter Within Mix Groups");
+
+    // only useful for layouts wider than stereo
+    if (proc.getTotalNumInputChannels() > 2)
+        addSettingItem (ChowtapeModelAudioProcessor::parallelChannelsID, "Parallel Channel Processing");
+}
+
 void SettingsButton::copyDiagnosticInfo()
 {
     Logger::writeToLog ("Copying diagnostic info...");
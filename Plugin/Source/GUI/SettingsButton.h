@@ -16,6 +16,7 @@ public:
 private:
     void showSettingsMenu();
     void openGLMenu (PopupMenu& menu, int itemID);
+    void processingMenu (PopupMenu& menu, int itemID);
     void copyDiagnosticInfo();
 
     const ChowtapeModelAudioProcessor& proc;
@@ -0,0 +1,60 @@
+#include "AudioFileStream.h"
+
+namespace
+{
+constexpr int64 mappedWindowSamples = 1 << 20;
+}
+
+AudioFileStream::AudioFileStream (AudioFormatManager& formatManager, const File& file, bool useMemoryMapping)
+{
+    if (useMemoryMapping)
+    {
+        for (int i = 0; i < formatManager.getNumKnownFormats(); ++i)
+        {
+            auto* format = formatManager.getKnownFormat (i);
+            if (! format->canHandleFile (file))
+                continue;
+
+            std::unique_ptr<MemoryMappedAudioFormatReader> mapped (format->createMemoryMappedReader (file));
+            if (mapped != nullptr && mapped->mapSectionOfFile ({ 0, jmin (mapped->lengthInSamples, mappedWindowSamples) }))
+            {
+                mappedReader = mapped.get();
+                reader = std::move (mapped);
+                return;
+            }
+        }
+    }
+
+    // formats that can't be memory-mapped are read through a regular (buffered) reader
+    reader.reset (formatManager.createReaderFor (file));
+}
+
+int AudioFileStream::read (AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    jassert (isOpen());
+
+    const auto numToRead = (int) jlimit ((int64) 0, (int64) numSamples, getLengthInSamples() - position);
+    if (numToRead < numSamples)
+        buffer.clear (startSample + numToRead, numSamples - numToRead);
+
+    if (numToRead == 0)
+        return 0;
+
+    if (mappedReader != nullptr)
+    {
+        // slide the mapped window along, so we never have the whole file mapped at once
+        const Range<int64> readRange { position, position + numToRead };
+        if (! mappedReader->getMappedSection().contains (readRange)
+            && ! mappedReader->mapSectionOfFile ({ position, jmin (getLengthInSamples(), position + jmax ((int64) numToRead, mappedWindowSamples)) }))
+        {
+            jassertfalse; // unable to map the file!
+            buffer.clear (startSample, numToRead);
+            return 0;
+        }
+    }
+
+    reader->read (&buffer, startSample, numToRead, position, true, true);
+    position += numToRead;
+
+    return numToRead;
+}
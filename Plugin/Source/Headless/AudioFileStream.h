@@ -0,0 +1,42 @@
+#ifndef AUDIOFILESTREAM_H_INCLUDED
+#define AUDIOFILESTREAM_H_INCLUDED
+
+#include <JuceHeader.h>
+
+/**
+ * Reads an audio file a block at a time, so that the memory used
+ * does not depend on the length of the file. Formats that support it
+ * (WAV and AIFF) can optionally be memory-mapped, in which case only
+ * a fixed-size window of the file is mapped at any one time.
+ */
+class AudioFileStream
+{
+public:
+    AudioFileStream (AudioFormatManager& formatManager, const File& file, bool useMemoryMapping);
+
+    bool isOpen() const noexcept { return reader != nullptr; }
+    bool isMemoryMapped() const noexcept { return mappedReader != nullptr; }
+
+    int getNumChannels() const noexcept { return (int) reader->numChannels; }
+    double getSampleRate() const noexcept { return reader->sampleRate; }
+    int64 getLengthInSamples() const noexcept { return reader->lengthInSamples; }
+
+    /** Moves the read position back to the start of the file */
+    void rewind() noexcept { position = 0; }
+
+    /**
+     * Reads the next samples from the file into the buffer. Anything past the
+     * end of the file is filled with silence, and a mono file is copied to both
+     * channels of a stereo buffer. Returns the number of samples read from the file.
+     */
+    int read (AudioBuffer<float>& buffer, int startSample, int numSamples);
+
+private:
+    std::unique_ptr<AudioFormatReader> reader;
+    MemoryMappedAudioFormatReader* mappedReader = nullptr; // points to reader, if memory-mapped
+    int64 position = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioFileStream)
+};
+
+#endif // AUDIOFILESTREAM_H_INCLUDED
@@ -0,0 +1,216 @@
+#include "BatchRender.h"
+#include "AudioFileStream.h"
+#include "../PluginProcessor.h"
+
+namespace
+{
+constexpr int blocksPerChunk = 16;
+constexpr uint64 defaultSeed = 0x43686f77; // fixed, so that re-rendering a file gives identical output
+
+struct RenderSettings
+{
+    File outputDirectory; // if not set, the output goes next to the input file
+    String suffix = "_ChowTape";
+    int blockSize = 512;
+    int bitDepth = 24;
+    uint64 seed = defaultSeed;
+    bool useMemoryMapping = false;
+};
+
+File getOutputFile (const File& inputFile, const RenderSettings& settings)
+{
+    const auto outputDirectory = settings.outputDirectory == File() ? inputFile.getParentDirectory() : settings.outputDirectory;
+    return outputDirectory.getChildFile (inputFile.getFileNameWithoutExtension() + settings.suffix + ".wav");
+}
+
+/** Renders one file through the plugin. Returns an error message if something went wrong. */
+String renderFile (ChowtapeModelAudioProcessor& plugin, AudioFormatManager& formatManager, const File& inputFile, const File& outputFile, const RenderSettings& settings)
+{
+    if (outputFile == inputFile)
+        return "output file would overwrite the input file";
+
+    AudioFileStream input (formatManager, inputFile, settings.useMemoryMapping);
+    if (! input.isOpen())
+        return "unable to read audio file";
+
+    const auto numChannels = input.getNumChannels();
+    const auto sampleRate = input.getSampleRate();
+    const auto totalNumSamples = input.getLengthInSamples();
+
+    plugin.releaseResources();
+
+    AudioProcessor::BusesLayout layout;
+    layout.inputBuses.add (AudioChannelSet::canonicalChannelSet (numChannels));
+    layout.outputBuses.add (AudioChannelSet::canonicalChannelSet (numChannels));
+    if (! plugin.setBusesLayout (layout))
+        return "unsupported number of channels (" + String (numChannels) + ")";
+
+    plugin.setNonRealtime (true);
+    plugin.setRandomSeed (settings.seed); // takes effect in prepareToPlay()
+    plugin.prepareToPlay (sampleRate, settings.blockSize);
+
+    outputFile.deleteFile();
+    auto outputStream = outputFile.createOutputStream();
+    if (outputStream == nullptr)
+        return "unable to create output file";
+
+    WavAudioFormat wavFormat;
+    std::unique_ptr<AudioFormatWriter> writer (wavFormat.createWriterFor (outputStream.get(), sampleRate, (unsigned int) numChannels, settings.bitDepth, {}, 0));
+    if (writer == nullptr)
+        return "unable to create output file writer";
+
+    outputStream.release(); // now owned by the writer
+
+    const auto chunkSize = settings.blockSize * blocksPerChunk;
+    AudioBuffer<float> chunk (numChannels, chunkSize);
+    MidiBuffer midi;
+
+    int64 samplesWritten = 0;
+    int latencyToSkip = -1; // the plugin latency is trimmed from the start of the output
+    while (samplesWritten < totalNumSamples)
+    {
+        // once we've reached the end of the input, the silence flushes out the plugin latency
+        input.read (chunk, 0, chunkSize);
+
+        for (int startSample = 0; startSample < chunkSize; startSample += settings.blockSize)
+        {
+            AudioBuffer<float> block (chunk.getArrayOfWritePointers(), numChannels, startSample, settings.blockSize);
+            plugin.processBlock (block, midi);
+        }
+
+        if (latencyToSkip < 0)
+            latencyToSkip = plugin.getLatencySamples();
+
+        const auto numToSkip = jmin (latencyToSkip, chunkSize);
+        latencyToSkip -= numToSkip;
+
+        const auto numToWrite = (int) jmin ((int64) (chunkSize - numToSkip), totalNumSamples - samplesWritten);
+        if (! writer->writeFromAudioSampleBuffer (chunk, numToSkip, numToWrite))
+            return "unable to write to output file";
+
+        samplesWritten += numToWrite;
+    }
+
+    plugin.releaseResources();
+    return {};
+}
+} // namespace
+
+BatchRender::BatchRender()
+{
+    this->commandOption = "--render";
+    this->argumentDescription = "--render --preset=FILE --output=DIR --suffix=SUFFIX --threads=NUM_THREADS --block-size=SIZE --bit-depth=BITS --seed=SEED --mmap FILE1 FILE2 ...";
+    this->shortDescription = "Renders audio files through ChowTapeModel";
+    this->longDescription = "Processes each input file with the given preset (or the default preset), and writes the result as a WAV file. "
+                            "Files are rendered in parallel, with one plugin instance per thread. "
+                            "All the random processes (degrade, chew, and wow) use a fixed seed (unless one is given), and the "
+                            "multi-threaded processing and mix group sharing settings are turned off, so re-rendering a preset is reproducible.";
+    this->command = std::bind (&BatchRender::runRender, this, std::placeholders::_1);
+}
+
+void BatchRender::runRender (const ArgumentList& args)
+{
+    Array<File> inputFiles;
+    for (const auto& arg : args.arguments)
+        if (! arg.isOption())
+            inputFiles.add (arg.resolveAsExistingFile());
+
+    if (inputFiles.isEmpty())
+        ConsoleApplication::fail ("No input files!");
+
+    RenderSettings settings;
+    if (args.containsOption ("--output"))
+    {
+        settings.outputDirectory = args.getFileForOption ("--output");
+        if (const auto result = settings.outputDirectory.createDirectory(); result.failed())
+            ConsoleApplication::fail ("Unable to create output directory: " + result.getErrorMessage());
+    }
+
+    if (args.containsOption ("--suffix"))
+        settings.suffix = args.getValueForOption ("--suffix");
+
+    if (args.containsOption ("--block-size"))
+        settings.blockSize = jmax (1, args.getValueForOption ("--block-size").getIntValue());
+
+    if (args.containsOption ("--bit-depth"))
+    {
+        settings.bitDepth = args.getValueForOption ("--bit-depth").getIntValue();
+        if (settings.bitDepth != 16 && settings.bitDepth != 24 && settings.bitDepth != 32)
+            ConsoleApplication::fail ("Bit depth must be 16, 24, or 32!");
+    }
+
+    if (args.containsOption ("--seed"))
+        settings.seed = (uint64) args.getValueForOption ("--seed").getLargeIntValue();
+
+    settings.useMemoryMapping = args.containsOption ("--mmap");
+
+    auto numThreads = SystemStats::getNumCpus();
+    if (args.containsOption ("--threads"))
+        numThreads = jmax (1, args.getValueForOption ("--threads").getIntValue());
+    numThreads = jmin (numThreads, inputFiles.size());
+
+    // the plugins are created (and the preset loaded) here on the message thread,
+    // so the worker threads only ever need to process audio
+    std::vector<std::unique_ptr<ChowtapeModelAudioProcessor>> plugins;
+    for (int i = 0; i < numThreads; ++i)
+    {
+        auto plugin = std::make_unique<ChowtapeModelAudioProcessor>();
+        if (args.containsOption ("--preset") && ! plugin->loadPresetFromFile (args.getExistingFileForOption ("--preset")))
+            ConsoleApplication::fail ("Unable to load preset!");
+
+        // each render should be independent of the user's settings, and of the other renders running in parallel
+        plugin->overrideGlobalSetting (ChowtapeModelAudioProcessor::parallelChannelsID, false);
+        plugin->overrideGlobalSetting (ChowtapeModelAudioProcessor::pipelinedID, false);
+        plugin->overrideGlobalSetting (ChowtapeModelAudioProcessor::sharedModulationID, false);
+        if (auto* mixGroupParam = plugin->getVTS().getParameter (MixGroupsConstants::mixGroupParamID))
+            mixGroupParam->setValueNotifyingHost (0.0f);
+
+        plugins.push_back (std::move (plugin));
+    }
+
+    std::cerr << "Rendering " << inputFiles.size() << " file(s) with " << numThreads << " thread(s)..." << std::endl;
+    const auto startTime = Time::getMillisecondCounterHiRes();
+
+    std::atomic<int> nextFileIndex { 0 };
+    std::atomic<int> numFailed { 0 };
+    CriticalSection printLock;
+
+    ThreadPool pool (numThreads);
+    for (auto& plugin : plugins)
+    {
+        pool.addJob ([&, pluginToUse = plugin.get()] {
+            AudioFormatManager formatManager;
+            formatManager.registerBasicFormats();
+
+            // each worker takes the next file that nobody has started on yet
+            for (auto fileIndex = nextFileIndex++; fileIndex < inputFiles.size(); fileIndex = nextFileIndex++)
+            {
+                const auto& inputFile = inputFiles.getReference (fileIndex);
+                const auto outputFile = getOutputFile (inputFile, settings);
+
+                const auto fileStartTime = Time::getMillisecondCounterHiRes();
+                const auto error = renderFile (*pluginToUse, formatManager, inputFile, outputFile, settings);
+                const auto fileTime = (Time::getMillisecondCounterHiRes() - fileStartTime) / 1000.0;
+
+                const ScopedLock sl (printLock);
+                if (error.isNotEmpty())
+                {
+                    numFailed++;
+                    std::cerr << "Error rendering " << inputFile.getFullPathName() << ": " << error << std::endl;
+                    continue;
+                }
+
+                std::cerr << "Rendered " << outputFile.getFullPathName() << " (" << fileTime << " seconds)" << std::endl;
+            }
+
+            return ThreadPoolJob::jobHasFinished;
+        });
+    }
+
+    while (pool.getNumJobs() > 0)
+        Thread::sleep (50);
+
+    std::cerr << "Finished in " << (Time::getMillisecondCounterHiRes() - startTime) / 1000.0 << " seconds" << std::endl;
+    if (numFailed > 0)
+        ConsoleApplication::fail (String (numFailed.load()) + " file(s) failed to render!");
+}
@@ -0,0 +1,24 @@
+#ifndef BATCHRENDER_H_INCLUDED
+#define BATCHRENDER_H_INCLUDED
+
+#include <JuceHeader.h>
+
+/**
+ * Renders a batch of audio files through the plugin, using a
+ * thread pool with one plugin instance per worker thread. The audio
+ * is streamed through the plugin in chunks, so the memory usage does
+ * not depend on the length of the files.
+ */
+class BatchRender : public ConsoleApplication::Command
+{
+public:
+    BatchRender();
+
+private:
+    /** Renders the files given on the command line */
+    void runRender (const ArgumentList& args);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BatchRender)
+};
+
+#endif // BATCHRENDER_H_INCLUDED
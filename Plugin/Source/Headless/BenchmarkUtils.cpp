@@ -0,0 +1,389 @@
+#include "BenchmarkUtils.h"
+
+namespace
+{
+double getPercentile (std::vector<double> values, double percentile)
+{
+    if (values.empty())
+        return 0.0;
+
+    const auto index = jlimit (0, (int) values.size() - 1, (int) std::ceil (percentile / 100.0 * (double) values.size()) - 1);
+    std::nth_element (values.begin(), values.begin() + index, values.end());
+    return values[(size_t) index];
+}
+
+String getCPUFrequencyGovernor()
+{
+#if JUCE_LINUX
+    const File governorFile ("/sys/devices/system/cpu/cpu0/cpufreq/scaling_governor");
+    if (governorFile.existsAsFile())
+        return governorFile.loadFileAsString().trim();
+#endif
+
+    return "unknown";
+}
+
+/** Fills the block with the input audio, starting from the given sample. Called for each block, in order. */
+using ReadFunc = std::function<void (AudioBuffer<float>&, int64)>;
+
+BenchmarkUtils::Result runBlocks (const BenchmarkUtils::PrepareFunc& prepare,
+                                  int64 totalNumSamples,
+                                  int numChannels,
+                                  double sampleRate,
+                                  int blockSize,
+                                  const BenchmarkUtils::Options& options,
+                                  const BenchmarkUtils::AutomationFunc& automation,
+                                  const ReadFunc& readBlock)
+{
+    BenchmarkUtils::Result result;
+    result.numSamples = totalNumSamples;
+    result.audioSeconds = (double) totalNumSamples / sampleRate;
+    result.blockPeriod = (double) blockSize / sampleRate;
+    result.runTimes.reserve ((size_t) options.numRuns);
+
+    // only one block of audio is kept in memory at a time
+    AudioBuffer<float> buffer (numChannels, blockSize);
+    for (int runIdx = 0; runIdx < options.numWarmupRuns + options.numRuns; ++runIdx)
+    {
+        // each run starts from a freshly prepared processor, and the same input audio
+        if (automation != nullptr)
+            automation (0.0);
+
+        const auto process = prepare();
+        const auto isWarmup = runIdx < options.numWarmupRuns;
+
+        auto runTime = 0.0;
+        for (int64 samplePtr = 0; samplePtr < totalNumSamples; samplePtr += blockSize)
+        {
+            const auto curBlockSize = (int) jmin (totalNumSamples - samplePtr, (int64) blockSize);
+            AudioBuffer<float> curBuff (buffer.getArrayOfWritePointers(), numChannels, curBlockSize);
+
+            // reading the input and parameter changes are done outside of the timed region, like a host would
+            readBlock (curBuff, samplePtr);
+            if (automation != nullptr)
+                automation ((double) samplePtr / sampleRate);
+
+            const auto start = Time::getHighResolutionTicks();
+            process (curBuff);
+            const auto blockTime = Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start);
+
+            runTime += blockTime;
+            if (! isWarmup)
+            {
+                result.blockTimes.add (blockTime);
+                if (blockTime > result.blockPeriod)
+                    result.numBlocksOverBudget++;
+            }
+        }
+
+        if (! isWarmup)
+            result.runTimes.push_back (runTime);
+    }
+
+    return result;
+}
+} // namespace
+
+namespace BenchmarkUtils
+{
+Options Options::fromArgs (const ArgumentList& args)
+{
+    Options options;
+    if (args.containsOption ("--warmup"))
+        options.numWarmupRuns = jmax (0, args.getValueForOption ("--warmup").getIntValue());
+
+    if (args.containsOption ("--runs"))
+        options.numRuns = jmax (1, args.getValueForOption ("--runs").getIntValue());
+
+    if (args.containsOption ("--automate"))
+        options.automatedParams.addTokens (args.getValueForOption ("--automate"), ",", {});
+
+    if (args.containsOption ("--automate-rate"))
+        options.automationRateHz = args.getValueForOption ("--automate-rate").getDoubleValue();
+
+    return options;
+}
+
+double Result::getMedianRunTime() const
+{
+    return getPercentile (runTimes, 50.0);
+}
+
+void BlockTimeHistogram::add (double seconds) noexcept
+{
+    const auto octave = std::log2 (jmax (1.0e-12, seconds * 1.0e6)) - (double) minOctave;
+    const auto binIndex = jlimit (0, numBins - 1, (int) std::floor (octave * (double) binsPerOctave));
+
+    counts[(size_t) binIndex]++;
+    numBlocks++;
+    maxTime = jmax (maxTime, seconds);
+}
+
+double BlockTimeHistogram::getBinUpperLimit (int binIndex) noexcept
+{
+    return std::exp2 ((double) (binIndex + 1) / (double) binsPerOctave + (double) minOctave) * 1.0e-6;
+}
+
+double BlockTimeHistogram::getPercentile (double percentile) const noexcept
+{
+    if (numBlocks == 0)
+        return 0.0;
+
+    // same rank as the nearest-rank percentile of the raw block times, rounded up to the edge of its bin
+    const auto rank = jlimit ((int64) 1, numBlocks, (int64) std::ceil (percentile / 100.0 * (double) numBlocks));
+    int64 cumulativeCount = 0;
+    for (int i = 0; i < numBins; ++i)
+    {
+        cumulativeCount += counts[(size_t) i];
+        if (cumulativeCount >= rank)
+            return jmin (getBinUpperLimit (i), maxTime);
+    }
+
+    return maxTime;
+}
+
+std::vector<std::pair<double, int64>> BlockTimeHistogram::getOctaveBins() const
+{
+    // bin i counts the blocks that took less than 2^i microseconds (and at least 2^(i-1))
+    std::vector<std::pair<double, int64>> histogram;
+    for (int i = 0; i < numBins; ++i)
+    {
+        if (counts[(size_t) i] == 0)
+            continue;
+
+        const auto octaveIndex = (size_t) jmax (0, i / binsPerOctave + minOctave + 1);
+        while (histogram.size() <= octaveIndex)
+            histogram.emplace_back (std::exp2 ((double) histogram.size()), 0);
+
+        histogram[octaveIndex].second += counts[(size_t) i];
+    }
+
+    return histogram;
+}
+
+double Result::getBlockTimePercentile (double percentile) const
+{
+    if (percentile >= 100.0)
+        return blockTimes.getMax();
+
+    return blockTimes.getPercentile (percentile);
+}
+
+void Result::printBlockTimeHistogram() const
+{
+    const auto histogram = getBlockTimeHistogram();
+    const auto maxCount = std::accumulate (histogram.begin(), histogram.end(), (int64) 1, [] (int64 m, const auto& bin) { return jmax (m, bin.second); });
+
+    std::cerr << "Block times (budget: " << blockPeriod * 1.0e6 << " us):" << std::endl;
+    for (const auto& [upperLimitMicroseconds, count] : histogram)
+    {
+        if (count == 0)
+            continue;
+
+        const auto barLength = jmax (1, roundToInt (50.0 * (double) count / (double) maxCount));
+        std::cerr << "    < " << String (upperLimitMicroseconds).paddedLeft (' ', 8) << " us | "
+                  << String::repeatedString ("#", barLength) << " " << count << std::endl;
+    }
+}
+
+var Result::toVar() const
+{
+    const auto minMax = std::minmax_element (runTimes.begin(), runTimes.end());
+    const auto mean = std::accumulate (runTimes.begin(), runTimes.end(), 0.0) / (double) runTimes.size();
+    const auto variance = std::accumulate (runTimes.begin(), runTimes.end(), 0.0, [mean] (double sum, double t) { return sum + (t - mean) * (t - mean); })
+                          / (double) runTimes.size();
+
+    auto* result = new DynamicObject();
+    result->setProperty ("audio_seconds", audioSeconds);
+    result->setProperty ("num_runs", (int) runTimes.size());
+    result->setProperty ("median_seconds", getMedianRunTime());
+    result->setProperty ("min_seconds", *minMax.first);
+    result->setProperty ("max_seconds", *minMax.second);
+    result->setProperty ("stddev_percent", 100.0 * std::sqrt (variance) / mean);
+    result->setProperty ("realtime_factor", getRealtimeFactor());
+    result->setProperty ("ns_per_sample", getMedianRunTime() * 1.0e9 / (double) numSamples);
+    result->setProperty ("block_median_us", getBlockTimePercentile (50.0) * 1.0e6);
+    result->setProperty ("block_p99_us", getBlockTimePercentile (99.0) * 1.0e6);
+    result->setProperty ("block_p999_us", getBlockTimePercentile (99.9) * 1.0e6);
+    result->setProperty ("block_max_us", getBlockTimePercentile (100.0) * 1.0e6);
+    result->setProperty ("block_budget_us", blockPeriod * 1.0e6);
+    result->setProperty ("blocks_over_budget", getNumBlocksOverBudget());
+
+    Array<var> histogram;
+    for (const auto& [upperLimitMicroseconds, count] : getBlockTimeHistogram())
+    {
+        auto* bin = new DynamicObject();
+        bin->setProperty ("upper_us", upperLimitMicroseconds);
+        bin->setProperty ("count", count);
+        histogram.add (var (bin));
+    }
+    result->setProperty ("block_histogram", histogram);
+
+    return var (result);
+}
+
+AutomationFunc createAutomation (AudioProcessor& plugin, const Options& options)
+{
+    Array<AudioProcessorParameter*> params;
+    for (const auto& paramName : options.automatedParams)
+    {
+        auto* param = [&]() -> AudioProcessorParameter* {
+            for (auto* p : plugin.getParameters())
+            {
+                if (auto* paramWithID = dynamic_cast<AudioProcessorParameterWithID*> (p); paramWithID != nullptr && paramWithID->paramID == paramName)
+                    return p;
+
+                if (p->getName (1024) == paramName)
+                    return p;
+            }
+
+            return nullptr;
+        }();
+
+        if (param == nullptr)
+            ConsoleApplication::fail ("Unable to find parameter to automate: " + paramName);
+
+        params.add (param);
+    }
+
+    if (params.isEmpty())
+        return {};
+
+    return [params, rateHz = options.automationRateHz] (double timeSeconds) {
+        for (int i = 0; i < params.size(); ++i)
+        {
+            // triangle wave, with the parameters spread out in phase
+            const auto phase = std::fmod (timeSeconds * rateHz + (double) i / (double) params.size(), 1.0);
+            const auto value = phase < 0.5 ? 2.0 * phase : 2.0 - 2.0 * phase;
+            params[i]->setValueNotifyingHost ((float) value);
+        }
+    };
+}
+
+Result run (const PrepareFunc& prepare, const AudioBuffer<float>& audio, double sampleRate, int blockSize, const Options& options, const AutomationFunc& automation)
+{
+    return runBlocks (prepare, audio.getNumSamples(), audio.getNumChannels(), sampleRate, blockSize, options, automation, [&audio] (AudioBuffer<float>& block, int64 startSample) {
+        for (int ch = 0; ch < block.getNumChannels(); ++ch)
+            block.copyFrom (ch, 0, audio, ch, (int) startSample, block.getNumSamples());
+    });
+}
+
+Result run (const PrepareFunc& prepare, AudioFileStream& audio, int numChannels, double sampleRate, int blockSize, const Options& options, const AutomationFunc& automation)
+{
+    return runBlocks (prepare, audio.getLengthInSamples(), numChannels, sampleRate, blockSize, options, automation, [&audio] (AudioBuffer<float>& block, int64 startSample) {
+        if (startSample == 0)
+            audio.rewind();
+
+        audio.read (block, 0, block.getNumSamples());
+    });
+}
+
+var getSystemInfo()
+{
+    StringArray isaFlags;
+    if (SystemStats::hasSSE2())
+        isaFlags.add ("SSE2");
+    if (SystemStats::hasSSE41())
+        isaFlags.add ("SSE4.1");
+    if (SystemStats::hasAVX())
+        isaFlags.add ("AVX");
+    if (SystemStats::hasAVX2())
+        isaFlags.add ("AVX2");
+    if (SystemStats::hasAVX512F())
+        isaFlags.add ("AVX512F");
+    if (SystemStats::hasNeon())
+        isaFlags.add ("NEON");
+
+    auto* info = new DynamicObject();
+    info->setProperty ("os", SystemStats::getOperatingSystemName());
+    info->setProperty ("cpu_vendor", SystemStats::getCpuVendor());
+    info->setProperty ("cpu_model", SystemStats::getCpuModel());
+    info->setProperty ("cpu_mhz", SystemStats::getCpuSpeedInMegahertz());
+    info->setProperty ("cpu_governor", getCPUFrequencyGovernor());
+    info->setProperty ("num_cpus", SystemStats::getNumCpus());
+    info->setProperty ("isa", isaFlags.joinIntoString (" "));
+#if JUCE_DEBUG
+    info->setProperty ("build", "Debug");
+#else
+    info->setProperty ("build", "Release");
+#endif
+    return var (info);
+}
+
+static int compareWithBaseline (const Array<var>& results, const var& baseline, double tolerancePercent)
+{
+    if (baseline["system"]["cpu_model"] != getSystemInfo()["cpu_model"])
+        std::cerr << "Warning: the baseline was recorded on a different CPU (" << baseline["system"]["cpu_model"].toString() << ")" << std::endl;
+
+    std::map<String, double> baselineTimes;
+    if (auto* baselineResults = baseline["results"].getArray())
+        for (const auto& result : *baselineResults)
+            baselineTimes[result["name"].toString()] = (double) result["median_seconds"];
+
+    int numRegressions = 0;
+    std::cerr << "Comparing with baseline (tolerance: " << tolerancePercent << "%):" << std::endl;
+    for (const auto& result : results)
+    {
+        const auto name = result["name"].toString();
+        const auto baselineIter = baselineTimes.find (name);
+        if (baselineIter == baselineTimes.end())
+        {
+            std::cerr << "    " << name << ": not in baseline" << std::endl;
+            continue;
+        }
+
+        const auto baselineTime = baselineIter->second;
+        const auto time = (double) result["median_seconds"];
+        const auto changePercent = 100.0 * (time - baselineTime) / baselineTime;
+
+        String verdict;
+        if (changePercent > tolerancePercent)
+        {
+            verdict = " REGRESSION";
+            numRegressions++;
+        }
+        else if (changePercent < -tolerancePercent)
+        {
+            verdict = " (improved)";
+        }
+
+        std::cerr << "    " << name << ": " << baselineTime * 1000.0 << " ms -> " << time * 1000.0 << " ms ("
+                  << (changePercent > 0.0 ? "+" : "") << String (changePercent, 1) << "%)" << verdict << std::endl;
+    }
+
+    return numRegressions;
+}
+
+void reportResults (const Array<var>& results, const Options& options, const ArgumentList& args)
+{
+    auto* report = new DynamicObject();
+    report->setProperty ("version", ProjectInfo::versionString);
+    report->setProperty ("system", getSystemInfo());
+    report->setProperty ("warmup_runs", options.numWarmupRuns);
+    report->setProperty ("runs", options.numRuns);
+    report->setProperty ("automation", options.automatedParams.joinIntoString (","));
+    report->setProperty ("automation_rate_hz", options.automationRateHz);
+    report->setProperty ("results", results);
+    const auto reportString = JSON::toString (var (report));
+
+    if (args.containsOption ("--output"))
+        args.getFileForOption ("--output").replaceWithText (reportString);
+    else
+        std::cout << reportString << std::endl;
+
+    if (! args.containsOption ("--compare"))
+        return;
+
+    const auto baseline = JSON::parse (args.getExistingFileForOption ("--compare"));
+    if (! baseline.isObject())
+        ConsoleApplication::fail ("Unable to read baseline results!");
+
+    double tolerancePercent = 5.0;
+    if (args.containsOption ("--tolerance"))
+        tolerancePercent = args.getValueForOption ("--tolerance").getDoubleValue();
+
+    const auto numRegressions = compareWithBaseline (results, baseline, tolerancePercent);
+    if (numRegressions > 0)
+        ConsoleApplication::fail (String (numRegressions) + " benchmark(s) were slower than the baseline!");
+}
+} // namespace BenchmarkUtils
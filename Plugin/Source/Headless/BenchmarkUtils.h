@@ -0,0 +1,121 @@
+#ifndef BENCHMARKUTILS_H_INCLUDED
+#define BENCHMARKUTILS_H_INCLUDED
+
+#include "AudioFileStream.h"
+
+/**
+ * Shared harness for the headless benchmarks. Each benchmark is run
+ * a few times to warm up, and then repeated, with every processBlock()
+ * call timed individually (and collected into a histogram), so that the
+ * results come with some idea of their variance.
+ */
+namespace BenchmarkUtils
+{
+using ProcessFunc = std::function<void (AudioBuffer<float>&)>;
+
+/** Prepares a fresh processor, and returns the function to process it with */
+using PrepareFunc = std::function<ProcessFunc()>;
+
+/** Called before each block with the current time (in seconds), e.g. to automate parameters */
+using AutomationFunc = std::function<void (double)>;
+
+struct Options
+{
+    int numWarmupRuns = 2;
+    int numRuns = 10;
+
+    StringArray automatedParams;
+    double automationRateHz = 0.5;
+
+    /** Reads --warmup=N, --runs=N, --automate=PARAM1,PARAM2, and --automate-rate=HZ */
+    static Options fromArgs (const ArgumentList& args);
+};
+
+/**
+ * Fixed-size histogram of the block times, with log-spaced bins (1/16th of an
+ * octave wide, so the percentiles are accurate to within ~4.5%), so that the
+ * memory used does not grow with the length of the benchmark.
+ */
+struct BlockTimeHistogram
+{
+    static constexpr int binsPerOctave = 16;
+    static constexpr int minOctave = -4; // the first bin starts at 2^-4 us
+    static constexpr int numOctaves = 26; // ...and the last bin ends at ~4 seconds
+    static constexpr int numBins = binsPerOctave * numOctaves;
+
+    void add (double seconds) noexcept;
+
+    int64 getNumBlocks() const noexcept { return numBlocks; }
+    double getMax() const noexcept { return maxTime; }
+
+    /** Returns the given percentile (0-100), in seconds */
+    double getPercentile (double percentile) const noexcept;
+
+    /** Returns the number of blocks in each power-of-two bin (in microseconds), as { upper limit, count } */
+    std::vector<std::pair<double, int64>> getOctaveBins() const;
+
+private:
+    static double getBinUpperLimit (int binIndex) noexcept; // seconds
+
+    std::array<int64, (size_t) numBins> counts {};
+    int64 numBlocks = 0;
+    double maxTime = 0.0;
+};
+
+struct Result
+{
+    double audioSeconds = 0.0;
+    double blockPeriod = 0.0; // seconds of audio in a full block
+    int64 numSamples = 0;
+    std::vector<double> runTimes; // seconds, one per (non-warmup) run
+    BlockTimeHistogram blockTimes; // one entry per processBlock() call
+    int64 numBlocksOverBudget = 0;
+
+    double getMedianRunTime() const;
+    double getRealtimeFactor() const { return audioSeconds / getMedianRunTime(); }
+
+    /** Returns the given percentile (0-100) of the time taken by one block */
+    double getBlockTimePercentile (double percentile) const;
+
+    /** Returns the number of blocks that took longer to process than the audio they contained */
+    int64 getNumBlocksOverBudget() const noexcept { return numBlocksOverBudget; }
+
+    /** Returns a histogram of the block times, with power-of-two bins, in microseconds */
+    std::vector<std::pair<double, int64>> getBlockTimeHistogram() const { return blockTimes.getOctaveBins(); }
+
+    /** Prints the block time histogram to stderr */
+    void printBlockTimeHistogram() const;
+
+    /** Returns the results as a JSON object */
+    var toVar() const;
+};
+
+/**
+ * Creates the scripted automation from the options. Each automated parameter
+ * is swept back and forth across its whole range at the automation rate.
+ * Parameters can be given by ID or by name.
+ */
+AutomationFunc createAutomation (AudioProcessor& plugin, const Options& options);
+
+/** Runs a benchmark for one processor configuration */
+Result run (const PrepareFunc& prepare, const AudioBuffer<float>& audio, double sampleRate, int blockSize, const Options& options, const AutomationFunc& automation = {});
+
+/**
+ * Runs a benchmark with the audio streamed from a file, one block at a time,
+ * so the memory used does not depend on the length of the file. The file
+ * is read outside of the timed region.
+ */
+Result run (const PrepareFunc& prepare, AudioFileStream& audio, int numChannels, double sampleRate, int blockSize, const Options& options, const AutomationFunc& automation = {});
+
+/** Returns information about the machine the benchmarks are running on */
+var getSystemInfo();
+
+/**
+ * Writes the results (to stdout, or to --output=FILE), and compares them with
+ * the baseline from --compare=FILE, if given. Each result should have a unique "name".
+ * Fails if any result is slower than the baseline by more than --tolerance=PERCENT.
+ */
+void reportResults (const Array<var>& results, const Options& options, const ArgumentList& args);
+} // namespace BenchmarkUtils
+
+#endif // BENCHMARKUTILS_H_INCLUDED
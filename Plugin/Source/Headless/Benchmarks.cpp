@@ -1,4 +1,5 @@
 #include "Benchmarks.h"
+#include "BenchmarkUtils.h"
 #include "../PluginProcessor.h"
 
 namespace
@@ -11,29 +12,12 @@ constexpr int nChs = 2;
 Benchmarks::Benchmarks()
 {
     this->commandOption = "--bench";
-    this->argumentDescription = "--bench --file=FILE --mode=MODE";
+    this->argumentDescription = "--bench --file=FILE --mmap --mode=MODE --warmup=NUM_RUNS --runs=NUM_RUNS --output=FILE --compare=FILE --tolerance=PERCENT --automate=PARAM1,PARAM2 --automate-rate=HZ";
     this->shortDescription = "Runs benchmarks for ChowTapeModel";
     this->longDescription = "";
     this->command = std::bind (&Benchmarks::runBenchmarks, this, std::placeholders::_1);
 }
 
-void getAudioFile (AudioBuffer<float>& buffer, const File& file)
-{
-    AudioFormatManager formatManager;
-    formatManager.registerBasicFormats();
-
-    std::unique_ptr<InputStream> inputStream = file.createInputStream();
-    if (inputStream == nullptr)
-        return;
-
-    std::unique_ptr<AudioFormatReader> reader (formatManager.createReaderFor (std::move (inputStream)));
-    if (reader == nullptr)
-        return;
-
-    buffer.setSize ((int) reader->numChannels, (int) reader->lengthInSamples);
-    reader->read (buffer.getArrayOfWritePointers(), buffer.getNumChannels(), 0, buffer.getNumSamples());
-}
-
 void setParameters (AudioProcessor* plugin, int mode)
 {
     auto params = plugin->getParameters();
@@ -42,47 +26,22 @@ void setParameters (AudioProcessor* plugin, int mode)
         if (param->getName (1024) == "Oversampling")
         {
             param->setValueNotifyingHost (3.0f / 4.0f); // 8x
-            std::cout << "Setting parameter " << param->getName (1024)
+            std::cerr << "Setting parameter " << param->getName (1024)
                       << ": " << param->getText (param->getValue(), 1024) << std::endl;
         }
 
         if (param->getName (1024) == "Tape Mode")
         {
             param->setValueNotifyingHost ((float) mode / 5.0f);
-            std::cout << "Setting parameter " << param->getName (1024)
+            std::cerr << "Setting parameter " << param->getName (1024)
                       << ": " << param->getText (param->getValue(), 1024) << std::endl;
         }
     }
 }
 
-double timeAudioProcess (AudioProcessor* plugin, AudioBuffer<float>& audio, const int blockSize)
-{
-    Time time;
-
-    auto totalNumSamples = audio.getNumSamples();
-    int samplePtr = 0;
-    MidiBuffer midi;
-
-    auto start = time.getMillisecondCounterHiRes();
-    while (totalNumSamples > 0)
-    {
-        auto curBlockSize = jmin (totalNumSamples, blockSize);
-        totalNumSamples -= curBlockSize;
-
-        AudioBuffer<float> curBuff (audio.getArrayOfWritePointers(), nChs, samplePtr, curBlockSize);
-        plugin->processBlock (curBuff, midi);
-
-        samplePtr += curBlockSize;
-    }
-
-    return (time.getMillisecondCounterHiRes() - start) / 1000.0;
-}
-
 void Benchmarks::runBenchmarks (const ArgumentList& args)
 {
-    ignoreUnused (args);
-
-    std::cout << "Loading plugin..." << std::endl;
+    std::cerr << "Loading plugin..." << std::endl;
     auto plugin = std::make_unique<ChowtapeModelAudioProcessor>();
 
     File audioFile;
@@ -99,29 +58,60 @@ void Benchmarks::runBenchmarks (const ArgumentList& args)
         audioFile = rootFolder.getChildFile ("Testing/Canada_Dry.wav");
     }
 
-    std::cout << "Loading audio file: " << audioFile.getFullPathName() << std::endl;
-    AudioBuffer<float> audio;
-    getAudioFile (audio, audioFile);
-    const double audioLength = audio.getNumSamples() / pluginSampleRate; // seconds
-
-    if (audioLength == 0.0)
+    // the audio is streamed from the file, so that long files don't need to fit in memory
+    std::cerr << "Opening audio file: " << audioFile.getFullPathName() << std::endl;
+    AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+    AudioFileStream audio (formatManager, audioFile, args.containsOption ("--mmap"));
+    if (! audio.isOpen() || audio.getLengthInSamples() == 0)
     {
-        std::cout << "No audio found in file!" << std::endl;
+        std::cerr << "No audio found in file!" << std::endl;
         return;
     }
 
-    std::cout << "Setting parameters..." << std::endl;
+    if (audio.isMemoryMapped())
+        std::cerr << "Using memory-mapped file reader" << std::endl;
+
+    std::cerr << "Setting parameters..." << std::endl;
     int mode = 4; // STN
     if (args.containsOption ("--mode"))
         mode = args.getValueForOption ("--mode").getIntValue();
     setParameters (plugin.get(), mode);
 
-    std::cout << "Processing audio..." << std::endl;
-    plugin->prepareToPlay (pluginSampleRate, samplesPerBlock);
-    auto time = timeAudioProcess (plugin.get(), audio, samplesPerBlock);
+    std::cerr << "Processing audio..." << std::endl;
+    const auto options = BenchmarkUtils::Options::fromArgs (args);
+    MidiBuffer midi;
+    const auto result = BenchmarkUtils::run (
+        [&]() -> BenchmarkUtils::ProcessFunc {
+            plugin->releaseResources();
+            plugin->prepareToPlay (pluginSampleRate, samplesPerBlock);
+            return [&] (AudioBuffer<float>& buffer) {
+                plugin->processBlock (buffer, midi);
+                if constexpr (StageProfiler::isEnabled())
+                    plugin->getStageProfiler().collect(); // there's no message loop to do this for us
+            };
+        },
+        audio,
+        nChs, // the plugin is always benchmarked in stereo
+        pluginSampleRate,
+        samplesPerBlock,
+        options,
+        BenchmarkUtils::createAutomation (*plugin, options));
     plugin->releaseResources();
 
-    std::cout << "Results:" << std::endl;
-    std::cout << audioLength / time << "x real-time" << std::endl;
-    std::cout << time << " seconds" << std::endl;
+    std::cerr << "Results:" << std::endl;
+    std::cerr << result.getRealtimeFactor() << "x real-time" << std::endl;
+    std::cerr << result.getMedianRunTime() << " seconds (median of " << options.numRuns << " runs)" << std::endl;
+    std::cerr << result.getBlockTimePercentile (99.0) * 1.0e6 << " us per block (99th percentile)" << std::endl;
+    std::cerr << result.getNumBlocksOverBudget() << " blocks over the real-time budget" << std::endl;
+    result.printBlockTimeHistogram();
+
+    if constexpr (StageProfiler::isEnabled())
+        std::cerr << plugin->getStageProfiler().getSummary() << std::endl;
+
+    auto resultVar = result.toVar();
+    resultVar.getDynamicObject()->setProperty ("name", "ChowTape mode " + String (mode));
+    resultVar.getDynamicObject()->setProperty ("sample_rate", pluginSampleRate);
+    resultVar.getDynamicObject()->setProperty ("block_size", samplesPerBlock);
+    BenchmarkUtils::reportResults ({ resultVar }, options, args);
 }
@@ -1,6 +1,9 @@
+#include "BatchRender.h"
 #include "Benchmarks.h"
 #include "FirBench.h"
+#include "RealtimeCheck.h"
 #include "ScreenshotHelper.h"
+#include "StageBenchmarks.h"
 #include "UnitTests/UnitTests.h"
 
 String getVersion()
@@ -34,9 +37,18 @@ int main (int argc, char* argv[])
     Benchmarks benchmarks;
     app.addCommand (benchmarks);
 
+    StageBenchmarks stageBenchmarks;
+    app.addCommand (stageBenchmarks);
+
     FirBench firBench;
     app.addCommand (firBench);
 
+    BatchRender batchRender;
+    app.addCommand (batchRender);
+
+    RealtimeCheck rtCheck;
+    app.addCommand (rtCheck);
+
     UnitTests unitTests;
     app.addCommand (unitTests);
 
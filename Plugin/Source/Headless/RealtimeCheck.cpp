@@ -0,0 +1,320 @@
+#include "RealtimeCheck.h"
+#include "../PluginProcessor.h"
+#include <cerrno>
+
+namespace
+{
+constexpr int maxBlockSize = 512;
+constexpr int blockSizes[] = { 1, 16, 31, 64, 128, 256, 441, 512 };
+constexpr double sampleRates[] = { 44100.0, 96000.0 };
+constexpr int maxNumChannels = 8;
+
+/**
+ * Allocation tracking for the audio thread, and for any worker threads that
+ * help out with the processing (e.g. parallel channels, or the pipeline).
+ * Only allocations made while a ScopedAllocationCheck is alive are counted,
+ * so the check itself (and any parameter changes) can allocate freely.
+ */
+std::atomic<bool> checkingAllocations { false };
+std::atomic<int> numAllocations { 0 };
+std::atomic<int> numDeallocations { 0 };
+thread_local bool isCheckingThread = false;
+
+inline bool shouldCount() noexcept
+{
+    // other threads (e.g. the JUCE timer thread) may allocate while we're processing, so they are not counted
+    return checkingAllocations.load (std::memory_order_relaxed) && (isCheckingThread || RealtimeWorkerPool::isWorkerThread());
+}
+
+inline void countAllocation() noexcept
+{
+    if (shouldCount())
+        ++numAllocations;
+}
+
+inline void countDeallocation (void* ptr) noexcept
+{
+    if (ptr != nullptr && shouldCount())
+        ++numDeallocations;
+}
+
+struct ScopedAllocationCheck
+{
+    ScopedAllocationCheck()
+    {
+        numAllocations = 0;
+        numDeallocations = 0;
+        isCheckingThread = true;
+        checkingAllocations = true;
+    }
+
+    ~ScopedAllocationCheck()
+    {
+        checkingAllocations = false;
+        isCheckingThread = false;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (ScopedAllocationCheck)
+};
+
+/** The sweep is run with each of the multi-threaded processing modes */
+struct ProcessingMode
+{
+    const char* name;
+    bool parallelChannels;
+    bool pipelined;
+    int numChannels; // parallel channel processing is only used for layouts wider than stereo
+};
+
+constexpr ProcessingMode processingModes[] = {
+    { "serial", false, false, 2 },
+    { "pipelined", false, true, 2 },
+    { "parallel channels", true, false, 8 },
+    { "parallel channels + pipelined", true, true, 8 },
+};
+} // namespace
+
+// The allocation functions are replaced for the whole headless app, but unless a
+// ScopedAllocationCheck is alive, they just forward to the usual implementations.
+#if defined(__GLIBC__)
+// On Linux, we can wrap the C allocation functions themselves, which
+// also catches allocations that don't go through operator new (e.g. HeapBlock)
+extern "C"
+{
+void* __libc_malloc (size_t);
+void* __libc_calloc (size_t, size_t);
+void* __libc_realloc (void*, size_t);
+void* __libc_memalign (size_t, size_t);
+void* __libc_valloc (size_t);
+void* __libc_pvalloc (size_t);
+void __libc_free (void*);
+
+void* malloc (size_t size) noexcept
+{
+    countAllocation();
+    return __libc_malloc (size);
+}
+
+void* calloc (size_t num, size_t size) noexcept
+{
+    countAllocation();
+    return __libc_calloc (num, size);
+}
+
+void* realloc (void* ptr, size_t size) noexcept
+{
+    countAllocation();
+    return __libc_realloc (ptr, size);
+}
+
+void* memalign (size_t alignment, size_t size) noexcept
+{
+    countAllocation();
+    return __libc_memalign (alignment, size);
+}
+
+void* aligned_alloc (size_t alignment, size_t size) noexcept
+{
+    countAllocation();
+    return __libc_memalign (alignment, size);
+}
+
+void* valloc (size_t size) noexcept
+{
+    countAllocation();
+    return __libc_valloc (size);
+}
+
+void* pvalloc (size_t size) noexcept
+{
+    countAllocation();
+    return __libc_pvalloc (size);
+}
+
+int posix_memalign (void** ptr, size_t alignment, size_t size) noexcept
+{
+    if (alignment % sizeof (void*) != 0 || ! isPowerOfTwo (alignment))
+        return EINVAL;
+
+    countAllocation();
+    auto* newPtr = __libc_memalign (alignment, size);
+    if (newPtr == nullptr)
+        return ENOMEM;
+
+    *ptr = newPtr;
+    return 0;
+}
+
+void free (void* ptr) noexcept
+{
+    countDeallocation (ptr);
+    __libc_free (ptr);
+}
+}
+#else
+// Elsewhere, we only replace the global operator new/delete, so C-style allocations are not caught.
+// The array, nothrow, and sized variants all forward to these by default, but the aligned variants
+// don't forward to the unaligned ones, so they are replaced as well.
+namespace
+{
+void* allocateAligned (size_t size, size_t alignment) noexcept
+{
+    size = size == 0 ? 1 : size;
+#if JUCE_WINDOWS
+    return _aligned_malloc (size, alignment);
+#else
+    void* ptr = nullptr;
+    return posix_memalign (&ptr, jmax (alignment, sizeof (void*)), size) == 0 ? ptr : nullptr;
+#endif
+}
+
+void freeAligned (void* ptr) noexcept
+{
+#if JUCE_WINDOWS
+    _aligned_free (ptr);
+#else
+    std::free (ptr);
+#endif
+}
+} // namespace
+
+void* operator new (size_t size)
+{
+    countAllocation();
+    if (auto* ptr = std::malloc (size == 0 ? 1 : size))
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+void operator delete (void* ptr) noexcept
+{
+    countDeallocation (ptr);
+    std::free (ptr);
+}
+
+void* operator new (size_t size, std::align_val_t alignment)
+{
+    countAllocation();
+    if (auto* ptr = allocateAligned (size, (size_t) alignment))
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+void operator delete (void* ptr, std::align_val_t) noexcept
+{
+    countDeallocation (ptr);
+    freeAligned (ptr);
+}
+#endif
+
+RealtimeCheck::RealtimeCheck()
+{
+    this->commandOption = "--rt-check";
+    this->argumentDescription = "--rt-check --blocks=NUM_BLOCKS --seed=SEED";
+    this->shortDescription = "Checks that ChowTapeModel does not allocate memory on the audio thread";
+    this->longDescription = "Processes audio with randomised parameters and block sizes, and fails if any memory allocations are made in processBlock()";
+    this->command = std::bind (&RealtimeCheck::runCheck, this, std::placeholders::_1);
+}
+
+void randomiseParameters (AudioProcessor* plugin, Random& rand, bool allParams)
+{
+    auto& params = plugin->getParameters();
+    const auto numToChange = allParams ? params.size() : rand.nextInt (4);
+    for (int i = 0; i < numToChange; ++i)
+    {
+        auto* param = allParams ? params[i] : params[rand.nextInt (params.size())];
+        param->setValueNotifyingHost (rand.nextFloat());
+    }
+}
+
+String getParameterState (AudioProcessor* plugin)
+{
+    StringArray paramStrings;
+    for (auto* param : plugin->getParameters())
+        paramStrings.add (param->getName (1024) + ": " + param->getCurrentValueAsText());
+
+    return paramStrings.joinIntoString (", ");
+}
+
+void RealtimeCheck::runCheck (const ArgumentList& args)
+{
+    int numBlocks = 500;
+    if (args.containsOption ("--blocks"))
+        numBlocks = args.getValueForOption ("--blocks").getIntValue();
+
+    int64 seed = 0x1234;
+    if (args.containsOption ("--seed"))
+        seed = args.getValueForOption ("--seed").getLargeIntValue();
+
+    Random rand (seed);
+    AudioBuffer<float> audio (maxNumChannels, maxBlockSize);
+    MidiBuffer midi;
+
+    int numFailedBlocks = 0;
+    int numBlocksChecked = 0;
+    for (const auto& mode : processingModes)
+    {
+        for (auto sampleRate : sampleRates)
+        {
+            std::cout << "Checking " << mode.name << " processing with " << mode.numChannels << " channels at sample rate " << sampleRate << " Hz..." << std::endl;
+            auto plugin = std::make_unique<ChowtapeModelAudioProcessor>();
+
+            // the processing modes are only set for this instance, so the user's settings are left alone
+            plugin->overrideGlobalSetting (ChowtapeModelAudioProcessor::parallelChannelsID, mode.parallelChannels);
+            plugin->overrideGlobalSetting (ChowtapeModelAudioProcessor::pipelinedID, mode.pipelined);
+            plugin->overrideGlobalSetting (ChowtapeModelAudioProcessor::sharedModulationID, false);
+
+            AudioProcessor::BusesLayout layout;
+            layout.inputBuses.add (AudioChannelSet::canonicalChannelSet (mode.numChannels));
+            layout.outputBuses.add (AudioChannelSet::canonicalChannelSet (mode.numChannels));
+            if (! plugin->setBusesLayout (layout))
+                ConsoleApplication::fail ("Unable to set a layout with " + String (mode.numChannels) + " channels!");
+
+            randomiseParameters (plugin.get(), rand, true);
+            plugin->prepareToPlay (sampleRate, maxBlockSize);
+
+            for (int i = 0; i < numBlocks; ++i)
+            {
+                // change some parameters in between blocks, the same way a host would
+                randomiseParameters (plugin.get(), rand, i % 50 == 0);
+
+                const auto blockSize = blockSizes[rand.nextInt (numElementsInArray (blockSizes))];
+                const auto processBypassed = rand.nextInt (20) == 0;
+                for (int ch = 0; ch < mode.numChannels; ++ch)
+                    for (int n = 0; n < blockSize; ++n)
+                        audio.setSample (ch, n, rand.nextFloat() * 2.0f - 1.0f);
+
+                AudioBuffer<float> block (audio.getArrayOfWritePointers(), mode.numChannels, blockSize);
+                {
+                    ScopedAllocationCheck check;
+                    if (processBypassed)
+                        plugin->processBlockBypassed (block, midi);
+                    else
+                        plugin->processBlock (block, midi);
+                }
+
+                numBlocksChecked++;
+                if (numAllocations == 0 && numDeallocations == 0)
+                    continue;
+
+                // only print the details for the first few failures
+                if (numFailedBlocks++ < 5)
+                {
+                    std::cout << "Block " << i << " (" << blockSize << " samples" << (processBypassed ? ", bypassed" : "")
+                              << "): " << numAllocations << " allocations, " << numDeallocations << " deallocations" << std::endl;
+                    std::cout << "    " << getParameterState (plugin.get()) << std::endl;
+                }
+            }
+
+            plugin->releaseResources();
+        }
+    }
+
+    std::cout << "Results:" << std::endl;
+    std::cout << numFailedBlocks << " out of " << numBlocksChecked << " blocks allocated memory" << std::endl;
+
+    if (numFailedBlocks > 0)
+        ConsoleApplication::fail ("Real-time safety check failed!");
+}
@@ -0,0 +1,23 @@
+#ifndef REALTIMECHECK_H_INCLUDED
+#define REALTIMECHECK_H_INCLUDED
+
+#include <JuceHeader.h>
+
+/**
+ * Checks that the plugin's processBlock() is real-time safe, by
+ * intercepting any memory allocations made while processing audio,
+ * over a randomised sweep of parameters and block sizes.
+ */
+class RealtimeCheck : public ConsoleApplication::Command
+{
+public:
+    RealtimeCheck();
+
+private:
+    /** Runs the real-time safety check, and fails if any allocations were made */
+    void runCheck (const ArgumentList& args);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RealtimeCheck)
+};
+
+#endif // REALTIMECHECK_H_INCLUDED
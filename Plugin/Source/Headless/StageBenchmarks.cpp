@@ -0,0 +1,245 @@
+#include "StageBenchmarks.h"
+#include "BenchmarkUtils.h"
+#include "../PluginProcessor.h"
+
+namespace
+{
+constexpr double sampleRates[] = { 44100.0, 48000.0, 96000.0 };
+constexpr int blockSizes[] = { 32, 256, 1024 };
+constexpr int nChs = 2;
+
+using BenchmarkUtils::ProcessFunc;
+
+/** A processing stage, in one configuration */
+struct Stage
+{
+    String name;
+    String config;
+    std::function<void (AudioProcessorValueTreeState&)> setParameters;
+    std::function<ProcessFunc (AudioProcessorValueTreeState&, BypassManager&, double, int)> create;
+};
+
+void setParameter (AudioProcessorValueTreeState& vts, const String& paramID, float value)
+{
+    auto* param = vts.getParameter (paramID);
+    jassert (param != nullptr); // parameter does not exist!
+    param->setValueNotifyingHost (param->convertTo0to1 (value));
+}
+
+AudioParameterChoice* getOversamplingParam (AudioProcessorValueTreeState& vts)
+{
+    for (auto* param : vts.processor.getParameters())
+        if (param->getName (1024) == "Oversampling")
+            return dynamic_cast<AudioParameterChoice*> (param);
+
+    return nullptr;
+}
+
+template <typename ProcType, typename PrepareFunc, typename ProcessBlockFunc>
+ProcessFunc createStage (std::unique_ptr<ProcType> proc, PrepareFunc&& prepare, ProcessBlockFunc&& process)
+{
+    prepare (*proc);
+    return [p = std::shared_ptr<ProcType> (std::move (proc)), process] (AudioBuffer<float>& buffer) { process (*p, buffer); };
+}
+
+std::vector<Stage> getStages()
+{
+    std::vector<Stage> stages;
+
+    stages.push_back ({ "InputFilters", "", [] (auto& vts) {
+                           setParameter (vts, "ifilt_onoff", 1.0f);
+                           setParameter (vts, "ifilt_low", 100.0f);
+                           setParameter (vts, "ifilt_high", 8000.0f);
+                           setParameter (vts, "ifilt_makeup", 1.0f); },
+                        [] (auto& vts, auto& bypassManager, double fs, int blockSize) {
+                            return createStage (
+                                std::make_unique<InputFilters> (vts, bypassManager, bypassManager),
+                                [=] (InputFilters& p) { p.prepareToPlay (fs, blockSize, nChs); },
+                                [] (InputFilters& p, AudioBuffer<float>& buffer) { p.processBlock (buffer); p.processBlockMakeup (buffer); });
+                        } });
+
+    stages.push_back ({ "ToneControl", "", [] (auto& vts) {
+                           setParameter (vts, "tone_onoff", 1.0f);
+                           setParameter (vts, "h_bass", 6.0f);
+                           setParameter (vts, "h_treble", -6.0f); },
+                        [] (auto& vts, auto&, double fs, int) {
+                            return createStage (
+                                std::make_unique<ToneControl> (vts),
+                                [=] (ToneControl& p) { p.prepare (fs, nChs); },
+                                [] (ToneControl& p, AudioBuffer<float>& buffer) { p.processBlockIn (buffer); p.processBlockOut (buffer); });
+                        } });
+
+    stages.push_back ({ "CompressionProcessor", "", [] (auto& vts) {
+                           setParameter (vts, "comp_onoff", 1.0f);
+                           setParameter (vts, "comp_amt", 6.0f); },
+                        [] (auto& vts, auto& bypassManager, double fs, int blockSize) {
+                            return createStage (
+                                std::make_unique<CompressionProcessor> (vts, bypassManager),
+                                [=] (CompressionProcessor& p) { p.prepare (fs, blockSize, nChs); },
+                                [] (CompressionProcessor& p, AudioBuffer<float>& buffer) { p.processBlock (buffer); });
+                        } });
+
+    // the hysteresis processor is benchmarked for each solver and oversampling factor
+    const StringArray modes { "RK2", "RK4", "NR4", "NR8", "STN", "V1" };
+    for (int mode = 0; mode < modes.size(); ++mode)
+    {
+        for (int osIndex = 0; osIndex < 5; ++osIndex)
+        {
+            const auto osFactor = 1 << osIndex;
+            stages.push_back ({ "HysteresisProcessor", modes[mode] + ", " + String (osFactor) + "x", [=] (auto& vts) {
+                                   setParameter (vts, "hyst_onoff", 1.0f);
+                                   setParameter (vts, "os_shared", 0.0f);
+                                   setParameter (vts, "mode", (float) mode);
+                                   if (auto* osParam = getOversamplingParam (vts))
+                                       *osParam = osIndex; },
+                                [] (auto& vts, auto& bypassManager, double fs, int blockSize) {
+                                    return createStage (
+                                        std::make_unique<HysteresisProcessor> (vts, bypassManager),
+                                        [=] (HysteresisProcessor& p) { p.prepareToPlay (fs, blockSize, nChs); },
+                                        [] (HysteresisProcessor& p, AudioBuffer<float>& buffer) { p.processBlock (buffer); });
+                                } });
+        }
+    }
+
+    stages.push_back ({ "ChewProcessor", "", [] (auto& vts) {
+                           setParameter (vts, "chew_onoff", 1.0f);
+                           setParameter (vts, "chew_depth", 0.5f);
+                           setParameter (vts, "chew_freq", 0.5f); },
+                        [] (auto& vts, auto& bypassManager, double fs, int blockSize) {
+                            return createStage (
+                                std::make_unique<ChewProcessor> (vts, bypassManager),
+                                [=] (ChewProcessor& p) { p.prepare (fs, blockSize, nChs); },
+                                [] (ChewProcessor& p, AudioBuffer<float>& buffer) { p.processBlock (buffer); });
+                        } });
+
+    stages.push_back ({ "DegradeProcessor", "", [] (auto& vts) {
+                           setParameter (vts, "deg_onoff", 1.0f);
+                           setParameter (vts, "deg_depth", 0.5f);
+                           setParameter (vts, "deg_amt", 0.5f);
+                           setParameter (vts, "deg_env", 0.5f); },
+                        [] (auto& vts, auto& bypassManager, double fs, int blockSize) {
+                            return createStage (
+                                std::make_unique<DegradeProcessor> (vts, bypassManager),
+                                [=] (DegradeProcessor& p) { p.prepareToPlay (fs, blockSize, nChs); },
+                                [] (DegradeProcessor& p, AudioBuffer<float>& buffer) { p.processBlock (buffer); });
+                        } });
+
+    stages.push_back ({ "WowFlutterProcessor", "", [] (auto& vts) {
+                           setParameter (vts, "flutter_onoff", 1.0f);
+                           setParameter (vts, "depth", 0.5f);
+                           setParameter (vts, "wow_depth", 0.5f);
+                           setParameter (vts, "wow_var", 0.5f); },
+                        [] (auto& vts, auto& bypassManager, double fs, int blockSize) {
+                            auto magicState = std::make_shared<foleys::MagicGUIState>(); // for the wow/flutter plots
+                            return createStage (
+                                std::make_unique<WowFlutterProcessor> (vts, bypassManager),
+                                [=] (WowFlutterProcessor& p) { p.initialisePlots (*magicState); p.prepareToPlay (fs, blockSize, nChs); },
+                                [magicState] (WowFlutterProcessor& p, AudioBuffer<float>& buffer) { p.processBlock (buffer); });
+                        } });
+
+    stages.push_back ({ "LossFilter", "", [] (auto& vts) {
+                           setParameter (vts, "loss_onoff", 1.0f);
+                           setParameter (vts, "azimuth", 30.0f); },
+                        [] (auto& vts, auto& bypassManager, double fs, int blockSize) {
+                            return createStage (
+                                std::make_unique<LossFilter> (vts, bypassManager),
+                                [=] (LossFilter& p) { p.prepare ((float) fs, blockSize, nChs); },
+                                [] (LossFilter& p, AudioBuffer<float>& buffer) { p.processBlock (buffer); });
+                        } });
+
+    return stages;
+}
+
+AudioBuffer<float> createTestSignal (double sampleRate, double lengthSeconds)
+{
+    AudioBuffer<float> audio (nChs, (int) (sampleRate * lengthSeconds));
+
+    Random rand (0x1234);
+    for (int ch = 0; ch < nChs; ++ch)
+    {
+        auto* x = audio.getWritePointer (ch);
+        for (int n = 0; n < audio.getNumSamples(); ++n)
+            x[n] = 0.5f * std::sin (MathConstants<float>::twoPi * 100.0f * (float) n / (float) sampleRate)
+                   + 0.1f * (rand.nextFloat() * 2.0f - 1.0f);
+    }
+
+    return audio;
+}
+} // namespace
+
+StageBenchmarks::StageBenchmarks()
+{
+    this->commandOption = "--bench-stages";
+    this->argumentDescription = "--bench-stages --stages=STAGE1,STAGE2 --length=SECONDS --warmup=NUM_RUNS --runs=NUM_RUNS --output=FILE --compare=FILE --tolerance=PERCENT --automate=PARAM1,PARAM2 --automate-rate=HZ";
+    this->shortDescription = "Runs benchmarks for each ChowTapeModel processing stage";
+    this->longDescription = "Times each processor on its own over a range of sample rates and block sizes, and writes the results as JSON (to stdout, or to the output file)";
+    this->command = std::bind (&StageBenchmarks::runBenchmarks, this, std::placeholders::_1);
+}
+
+void StageBenchmarks::runBenchmarks (const ArgumentList& args)
+{
+    StringArray stageNames;
+    if (args.containsOption ("--stages"))
+        stageNames.addTokens (args.getValueForOption ("--stages"), ",", {});
+
+    double lengthSeconds = 1.0;
+    if (args.containsOption ("--length"))
+        lengthSeconds = args.getValueForOption ("--length").getDoubleValue();
+
+    const auto options = BenchmarkUtils::Options::fromArgs (args);
+
+    // the plugin is only used for its parameters, each stage is created separately
+    auto plugin = std::make_unique<ChowtapeModelAudioProcessor>();
+    auto& vts = plugin->getVTS();
+    const auto defaultState = vts.copyState();
+    const auto automation = BenchmarkUtils::createAutomation (*plugin, options);
+
+    Array<var> results;
+    for (const auto& stage : getStages())
+    {
+        if (! stageNames.isEmpty() && ! stageNames.contains (stage.name, true))
+            continue;
+
+        vts.replaceState (defaultState.createCopy());
+        stage.setParameters (vts);
+
+        for (auto sampleRate : sampleRates)
+        {
+            const auto testSignal = createTestSignal (sampleRate, lengthSeconds);
+            for (auto blockSize : blockSizes)
+            {
+                BypassManager bypassManager;
+                bypassManager.prepare (blockSize * 2, nChs); // same as the plugin
+                const auto result = BenchmarkUtils::run (
+                    [&]() -> ProcessFunc {
+                        return [&bypassManager, process = stage.create (vts, bypassManager, sampleRate, blockSize)] (AudioBuffer<float>& buffer) {
+                            bypassManager.beginBlock();
+                            process (buffer);
+                        };
+                    },
+                    testSignal,
+                    sampleRate,
+                    blockSize,
+                    options,
+                    automation);
+
+                const auto name = stage.name + (stage.config.isEmpty() ? String() : " (" + stage.config + ")")
+                                  + " @ " + String (sampleRate) + " Hz, " + String (blockSize) + " samples";
+                std::cerr << name << ": " << result.getRealtimeFactor() << "x real-time, "
+                          << result.getBlockTimePercentile (99.0) * 1.0e6 << " us (p99) / "
+                          << result.getBlockTimePercentile (100.0) * 1.0e6 << " us (max) per block" << std::endl;
+
+                auto resultVar = result.toVar();
+                auto* resultObject = resultVar.getDynamicObject();
+                resultObject->setProperty ("name", name);
+                resultObject->setProperty ("stage", stage.name);
+                resultObject->setProperty ("config", stage.config);
+                resultObject->setProperty ("sample_rate", sampleRate);
+                resultObject->setProperty ("block_size", blockSize);
+                results.add (resultVar);
+            }
+        }
+    }
+
+    BenchmarkUtils::reportResults (results, options, args);
+}
@@ -0,0 +1,23 @@
+#ifndef STAGEBENCHMARKS_H_INCLUDED
+#define STAGEBENCHMARKS_H_INCLUDED
+
+#include <JuceHeader.h>
+
+/**
+ * Benchmarks each of the plugin's processing stages on its own,
+ * over a range of sample rates and block sizes, and writes the
+ * results as JSON.
+ */
+class StageBenchmarks : public ConsoleApplication::Command
+{
+public:
+    StageBenchmarks();
+
+private:
+    /** Run per-stage benchmarks for ChowTape */
+    void runBenchmarks (const ArgumentList& args);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (StageBenchmarks)
+};
+
+#endif // STAGEBENCHMARKS_H_INCLUDED
@@ -0,0 +1,65 @@
+#include "Processors/Degrade/DegradeNoise.h"
+
+class DegradeNoiseTest : public UnitTest
+{
+public:
+    DegradeNoiseTest() : UnitTest ("DegradeNoiseTest")
+    {
+    }
+
+    static std::vector<float> renderNoise (uint64 seed, int numSamples, int blockSize)
+    {
+        DegradeNoise noise;
+        noise.setSeed (seed);
+        noise.setGain (1.0f);
+        noise.prepare();
+
+        std::vector<float> out ((size_t) numSamples, 0.0f);
+        for (int n = 0; n < numSamples; n += blockSize)
+            noise.processBlock (out.data() + n, jmin (blockSize, numSamples - n));
+
+        return out;
+    }
+
+    void reproducibilityTest()
+    {
+        constexpr int numSamples = 4096;
+        const auto ref = renderNoise (1234, numSamples, numSamples);
+
+        for (auto blockSize : { 1, 7, 64, 333 })
+        {
+            const auto test = renderNoise (1234, numSamples, blockSize);
+            expect (test == ref, "Noise stream changes with block size: " + String (blockSize));
+        }
+
+        const auto other = renderNoise (1235, numSamples, numSamples);
+        expect (other != ref, "Different seeds should give different noise!");
+    }
+
+    void rangeTest()
+    {
+        constexpr int numSamples = 1 << 16;
+        const auto noise = renderNoise (42, numSamples, 512);
+
+        double mean = 0.0;
+        for (auto x : noise)
+        {
+            expect (x >= -0.5f && x < 0.5f, "Noise sample out of range: " + String (x));
+            mean += (double) x;
+        }
+
+        mean /= (double) numSamples;
+        expectWithinAbsoluteError (mean, 0.0, 0.01, "Noise is not zero-mean!");
+    }
+
+    void runTest() override
+    {
+        beginTest ("Reproducibility Test");
+        reproducibilityTest();
+
+        beginTest ("Range Test");
+        rangeTest();
+    }
+};
+
+static DegradeNoiseTest degradeNoiseTest;
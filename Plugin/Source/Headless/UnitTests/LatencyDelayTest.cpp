@@ -0,0 +1,61 @@
+#include "Processors/LatencyDelayLine.h"
+
+class LatencyDelayTest : public UnitTest
+{
+public:
+    LatencyDelayTest() : UnitTest ("LatencyDelayTest")
+    {
+    }
+
+    void referenceTest (float delaySamples)
+    {
+        constexpr int numChannels = 2;
+        constexpr int blockSize = 128;
+        constexpr int numBlocks = 8;
+        const dsp::ProcessSpec spec { 48000.0, (uint32) blockSize, (uint32) numChannels };
+
+        chowdsp::DelayLine<float, chowdsp::DelayLineInterpolationTypes::Lagrange5th> refDelay { 1024 };
+        refDelay.prepare (spec);
+        refDelay.setDelay (delaySamples);
+
+        LatencyDelayLine delay { 1024 };
+        delay.prepare (spec);
+        delay.setDelay (delaySamples);
+
+        Random rand (0x5678);
+        AudioBuffer<float> buffer (numChannels, blockSize);
+        AudioBuffer<float> refBuffer (numChannels, blockSize);
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+                for (int n = 0; n < blockSize; ++n)
+                    buffer.setSample (ch, n, rand.nextFloat() * 2.0f - 1.0f);
+
+            refBuffer.makeCopyOf (buffer);
+            dsp::AudioBlock<float> refBlock { refBuffer };
+            refDelay.process (dsp::ProcessContextReplacing<float> { refBlock });
+
+            // push the whole block first, then read it back, like DryWetProcessor does
+            for (int ch = 0; ch < numChannels; ++ch)
+                for (int n = 0; n < blockSize; ++n)
+                    delay.pushSample (ch, buffer.getSample (ch, n));
+
+            for (int ch = 0; ch < numChannels; ++ch)
+                for (int n = 0; n < blockSize; ++n)
+                    expectWithinAbsoluteError (delay.popSample (ch), refBuffer.getSample (ch, n), 1.0e-5f, "Delay output does not match reference for delay: " + String (delaySamples));
+        }
+    }
+
+    void runTest() override
+    {
+        beginTest ("Integer Delay Test");
+        for (auto delaySamples : { 0.0f, 1.0f, 5.0f, 200.0f })
+            referenceTest (delaySamples);
+
+        beginTest ("Fractional Delay Test");
+        for (auto delaySamples : { 0.5f, 1.25f, 7.7f, 150.4f })
+            referenceTest (delaySamples);
+    }
+};
+
+static LatencyDelayTest latencyDelayTest;
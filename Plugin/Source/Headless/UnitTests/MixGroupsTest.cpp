@@ -102,6 +102,85 @@ public:
         }
     }
 
+    void threadedParameterTest()
+    {
+        auto plugin1 = createPlugin();
+        auto plugin2 = createPlugin();
+
+        setMixGroup (plugin1.get(), 1.0f);
+        setMixGroup (plugin2.get(), 1.0f);
+
+        // the host may change parameters from any thread (e.g. automation on the audio thread)
+        auto params1 = plugin1->getParameters();
+        std::thread automationThread ([&params1] {
+            Random rand (0x2345);
+            for (int i = 0; i < 1000; ++i)
+            {
+                auto* param = dynamic_cast<RangedAudioParameter*> (params1[rand.nextInt (params1.size())]);
+                if (param != nullptr && param->paramID != MixGroupsConstants::mixGroupParamID)
+                    param->setValueNotifyingHost (rand.nextFloat());
+            }
+        });
+        automationThread.join();
+
+        MessageManager::getInstance()->runDispatchLoopUntil (100);
+        compareStates (plugin1.get(), plugin2.get());
+    }
+
+    void sharedModulationTest()
+    {
+        constexpr double controlRate = 3000.0;
+        constexpr int framesPerBlock = 4;
+
+        auto buffer = std::make_unique<SharedModulationBuffer<1>>();
+        SharedModulationBuffer<1>::Client leader, follower;
+        leader.prepare (framesPerBlock);
+        follower.prepare (framesPerBlock);
+        leader.setBuffer (buffer.get(), 1);
+        follower.setBuffer (buffer.get(), 2);
+
+        std::vector<float> popped;
+        float nextValue = 0.0f;
+        auto processLeader = [&] {
+            expect (leader.beginBlock (controlRate, framesPerBlock), "First plugin should be the group leader!");
+            for (int i = 0; i < framesPerBlock; ++i)
+                leader.push ({ nextValue++ });
+            leader.endBlock();
+        };
+
+        auto processFollower = [&] {
+            expect (! follower.beginBlock (controlRate, framesPerBlock), "Second plugin should not be the group leader!");
+            for (int i = 0; i < framesPerBlock; ++i)
+                popped.push_back (follower.pop()[0]);
+            follower.endBlock();
+        };
+
+        constexpr int numBlocks = 100;
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            // the host may process the plugins in either order
+            if (getRandom().nextBool())
+            {
+                processLeader();
+                processFollower();
+            }
+            else
+            {
+                processFollower();
+                processLeader();
+            }
+        }
+
+        // once it has caught up, the follower should get an unbroken (delayed) copy of the leader's modulation
+        for (size_t i = 10 * framesPerBlock; i < popped.size() - 1; ++i)
+            expectEquals (popped[i + 1] - popped[i], 1.0f, "Shared modulation is discontinuous!");
+
+        // when the leader leaves, someone else should take over
+        leader.setBuffer (nullptr, 1);
+        expect (follower.beginBlock (controlRate, framesPerBlock), "Leadership was not handed over!");
+        follower.endBlock();
+    }
+
     void runTest() override
     {
         beginTest ("Copy State Test");
@@ -109,6 +188,12 @@ public:
 
         beginTest ("Parameter Link Test");
         parameterLinkTest();
+
+        beginTest ("Threaded Parameter Test");
+        threadedParameterTest();
+
+        beginTest ("Shared Modulation Test");
+        sharedModulationTest();
     }
 };
 
@@ -56,6 +56,51 @@ public:
         plugin->processBlock (buffer, midi);
     }
 
+    void parallelChannelsTest (int numChannels)
+    {
+        auto&& plugin = createPlugin();
+        auto& vts = plugin->getVTS();
+
+        constexpr double sampleRate = 48000.0;
+        constexpr int blockSize = 512;
+        constexpr int numBlocks = 10;
+
+        // the same processor, running serially and in parallel, should give the same output
+        BypassManager serialBypass, parallelBypass;
+        HysteresisProcessor serialProc (vts, serialBypass);
+        HysteresisProcessor parallelProc (vts, parallelBypass);
+        for (auto* bypass : { &serialBypass, &parallelBypass })
+            bypass->prepare (blockSize * (1 + 16), numChannels);
+        serialProc.prepareToPlay (sampleRate, blockSize, numChannels);
+        parallelProc.prepareToPlay (sampleRate, blockSize, numChannels);
+        parallelProc.setParallelChannelProcessing (true);
+
+        Random rand (0x1234);
+        AudioBuffer<float> serialBuffer (numChannels, blockSize);
+        AudioBuffer<float> parallelBuffer (numChannels, blockSize);
+        for (int i = 0; i < numBlocks; ++i)
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+                for (int n = 0; n < blockSize; ++n)
+                    serialBuffer.setSample (ch, n, rand.nextFloat() * 2.0f - 1.0f);
+            parallelBuffer.makeCopyOf (serialBuffer, true);
+
+            serialBypass.beginBlock();
+            serialProc.processBlock (serialBuffer);
+            parallelBypass.beginBlock();
+            parallelProc.processBlock (parallelBuffer);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                auto maxError = 0.0f;
+                for (int n = 0; n < blockSize; ++n)
+                    maxError = jmax (maxError, std::abs (serialBuffer.getSample (ch, n) - parallelBuffer.getSample (ch, n)));
+
+                expectEquals (maxError, 0.0f, "Parallel output is different from serial output at channel " + String (ch));
+            }
+        }
+    }
+
     void runTest() override
     {
         beginTest ("Mono Test");
@@ -78,6 +123,9 @@ public:
 
         beginTest ("7.1 Test");
         multiChannelTest (getLayout (AudioChannelSet::create7point1()));
+
+        beginTest ("Parallel Channels Test");
+        parallelChannelsTest (16);
     }
 };
 
@@ -0,0 +1,89 @@
+#include "PluginProcessor.h"
+
+class PipelineTest : public UnitTest
+{
+    using Proc = ChowtapeModelAudioProcessor;
+
+public:
+    PipelineTest() : UnitTest ("PipelineTest") {}
+
+    static constexpr double sampleRate = 48000.0;
+    static constexpr int maxBlockSize = 512;
+
+    std::unique_ptr<Proc> createPlugin (bool isPipelined)
+    {
+        auto proc = createPluginFilterOfType (AudioProcessor::WrapperType::wrapperType_Standalone);
+        std::unique_ptr<Proc> plugin (dynamic_cast<Proc*> (proc));
+
+        // only for this instance, so the user's settings are left alone
+        plugin->overrideGlobalSetting (Proc::pipelinedID, isPipelined);
+        plugin->overrideGlobalSetting (Proc::parallelChannelsID, false);
+        plugin->overrideGlobalSetting (Proc::sharedModulationID, false);
+
+        // turn off the stages with randomness, so that two plugins give the same output
+        for (auto* paramID : { "chew_onoff", "deg_onoff", "flutter_onoff" })
+            if (auto* param = plugin->getVTS().getParameter (paramID))
+                param->setValueNotifyingHost (0.0f);
+
+        return plugin;
+    }
+
+    AudioBuffer<float> processWithPlugin (Proc& plugin, const AudioBuffer<float>& input)
+    {
+        AudioBuffer<float> output;
+        output.makeCopyOf (input);
+
+        // the host block size changes from block to block
+        constexpr int blockSizes[] = { maxBlockSize, maxBlockSize / 2, 100, maxBlockSize, 1 };
+        plugin.prepareToPlay (sampleRate, maxBlockSize);
+
+        MidiBuffer midi;
+        int blockIndex = 0;
+        for (int startSample = 0; startSample < output.getNumSamples();)
+        {
+            const auto numSamples = jmin (blockSizes[blockIndex++ % (int) std::size (blockSizes)], output.getNumSamples() - startSample);
+            AudioBuffer<float> block (output.getArrayOfWritePointers(), output.getNumChannels(), startSample, numSamples);
+            plugin.processBlock (block, midi);
+            startSample += numSamples;
+        }
+
+        return output;
+    }
+
+    void pipelineTest()
+    {
+        AudioBuffer<float> input (2, (int) sampleRate);
+        Random rand (0x1234);
+        for (int ch = 0; ch < input.getNumChannels(); ++ch)
+            for (int n = 0; n < input.getNumSamples(); ++n)
+                input.setSample (ch, n, rand.nextFloat() * 2.0f - 1.0f);
+
+        auto serialPlugin = createPlugin (false);
+        const auto serialOutput = processWithPlugin (*serialPlugin, input);
+        const auto serialLatency = serialPlugin->getLatencySamples();
+
+        auto pipelinedPlugin = createPlugin (true);
+        const auto pipelinedOutput = processWithPlugin (*pipelinedPlugin, input);
+        const auto pipelinedLatency = pipelinedPlugin->getLatencySamples();
+
+        expectEquals (pipelinedLatency - serialLatency, maxBlockSize, "Pipelined latency is incorrect!");
+
+        // the pipelined output should be the same as the serial output, one block later
+        for (int ch = 0; ch < input.getNumChannels(); ++ch)
+        {
+            auto maxError = 0.0f;
+            for (int n = 0; n < input.getNumSamples() - maxBlockSize; ++n)
+                maxError = jmax (maxError, std::abs (serialOutput.getSample (ch, n) - pipelinedOutput.getSample (ch, n + maxBlockSize)));
+
+            expectLessThan (maxError, 1.0e-6f, "Pipelined output does not match serial output at channel " + String (ch));
+        }
+    }
+
+    void runTest() override
+    {
+        beginTest ("Pipeline Test");
+        pipelineTest();
+    }
+};
+
+static PipelineTest pipelineTest;
@@ -0,0 +1,197 @@
+#include "Processors/Hysteresis/MultiChannelShelfFilter.h"
+
+class ShelfFilterTest : public UnitTest
+{
+public:
+    ShelfFilterTest() : UnitTest ("ShelfFilterTest")
+    {
+    }
+
+    void referenceTest (float lowGain, float highGain, float fc)
+    {
+        constexpr int numChannels = 3; // not a multiple of the SIMD width
+        constexpr int numSamples = 1000;
+        constexpr float fs = 48000.0f;
+
+        Random rand (0x1234);
+        AudioBuffer<float> buffer (numChannels, numSamples);
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int n = 0; n < numSamples; ++n)
+                buffer.setSample (ch, n, rand.nextFloat() * 2.0f - 1.0f);
+
+        AudioBuffer<float> refBuffer;
+        refBuffer.makeCopyOf (buffer);
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            chowdsp::ShelfFilter<float> refFilter;
+            refFilter.reset();
+            refFilter.calcCoefs (lowGain, highGain, fc, fs);
+            refFilter.processBlock (refBuffer.getWritePointer (ch), numSamples);
+        }
+
+        MultiChannelShelfFilter filter;
+        filter.prepare (numChannels);
+        const auto coefs = MultiChannelShelfFilter::calcCoefs (lowGain, highGain, fc, fs);
+        filter.process (buffer.getArrayOfWritePointers(), numChannels, 0, numSamples, coefs, coefs);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int n = 0; n < numSamples; ++n)
+                expectWithinAbsoluteError (buffer.getSample (ch, n), refBuffer.getSample (ch, n), 1.0e-5f, "Output does not match reference filter!");
+    }
+
+    static AudioBuffer<float> makeNoise (int numChannels, int numSamples)
+    {
+        Random rand (0x1234);
+        AudioBuffer<float> buffer (numChannels, numSamples);
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int n = 0; n < numSamples; ++n)
+                buffer.setSample (ch, n, rand.nextFloat() * 2.0f - 1.0f);
+
+        return buffer;
+    }
+
+    void rampTest()
+    {
+        constexpr int numChannels = 3;
+        constexpr int numSamples = 500;
+        constexpr float fs = 48000.0f;
+
+        const auto startCoefs = MultiChannelShelfFilter::calcCoefs (1.0f, Decibels::decibelsToGain (-12.0f), 500.0f, fs);
+        const auto endCoefs = MultiChannelShelfFilter::calcCoefs (Decibels::decibelsToGain (9.0f), 1.0f, 3000.0f, fs);
+
+        auto buffer = makeNoise (numChannels, numSamples);
+        AudioBuffer<float> refBuffer;
+        refBuffer.makeCopyOf (buffer);
+
+        // reference: scalar filter, with the coefficients interpolated on every sample
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            auto* x = refBuffer.getWritePointer (ch);
+            float z = 0.0f;
+            for (int n = 0; n < numSamples; ++n)
+            {
+                const auto alpha = (float) (n + 1) / (float) numSamples;
+                const auto b0 = startCoefs.b0 + alpha * (endCoefs.b0 - startCoefs.b0);
+                const auto b1 = startCoefs.b1 + alpha * (endCoefs.b1 - startCoefs.b1);
+                const auto a1 = startCoefs.a1 + alpha * (endCoefs.a1 - startCoefs.a1);
+
+                const auto y = z + x[n] * b0;
+                z = x[n] * b1 - y * a1;
+                x[n] = y;
+            }
+        }
+
+        MultiChannelShelfFilter filter;
+        filter.prepare (numChannels);
+        filter.process (buffer.getArrayOfWritePointers(), numChannels, 0, numSamples, startCoefs, endCoefs);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int n = 0; n < numSamples; ++n)
+                expectWithinAbsoluteError (buffer.getSample (ch, n), refBuffer.getSample (ch, n), 1.0e-5f, "Ramped output does not match reference!");
+    }
+
+    void strideTest (int stride)
+    {
+        constexpr int numChannels = 3;
+        constexpr int numSamples = 4800;
+        constexpr int changeSample = 1000; // the gain changes in the middle of the block
+        constexpr float fs = 48000.0f;
+        constexpr float fc = 1000.0f;
+        const auto highGain = Decibels::decibelsToGain (-3.0f);
+
+        using SmoothGain = SmoothedValue<float, ValueSmoothingTypes::Multiplicative>;
+        auto makeSmoother = [] {
+            SmoothGain lowGain;
+            lowGain.reset ((double) fs, 0.05);
+            lowGain.setCurrentAndTargetValue (1.0f);
+            return lowGain;
+        };
+
+        auto buffer = makeNoise (numChannels, numSamples);
+        AudioBuffer<float> refBuffer;
+        refBuffer.makeCopyOf (buffer);
+
+        // reference: chowdsp::ShelfFilter, with the coefficients re-computed on every sample
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            auto lowGain = makeSmoother();
+            chowdsp::ShelfFilter<float> refFilter;
+            refFilter.reset();
+
+            auto* x = refBuffer.getWritePointer (ch);
+            for (int n = 0; n < numSamples; ++n)
+            {
+                if (n == changeSample)
+                    lowGain.setTargetValue (Decibels::decibelsToGain (12.0f));
+
+                refFilter.calcCoefs (lowGain.getNextValue(), highGain, fc, fs);
+                x[n] = refFilter.processSample (x[n]);
+            }
+        }
+
+        // coefficients computed once per stride, as in ToneStage::processBlock()
+        auto lowGain = makeSmoother();
+        MultiChannelShelfFilter filter;
+        filter.prepare (numChannels);
+        auto coefs = MultiChannelShelfFilter::calcCoefs (lowGain.getCurrentValue(), highGain, fc, fs);
+        for (int start = 0; start < numSamples; start += stride)
+        {
+            if (start == changeSample)
+                lowGain.setTargetValue (Decibels::decibelsToGain (12.0f));
+
+            const auto samplesToProcess = jmin (stride, numSamples - start);
+            const auto nextCoefs = MultiChannelShelfFilter::calcCoefs (lowGain.skip (samplesToProcess), highGain, fc, fs);
+            filter.process (buffer.getArrayOfWritePointers(), numChannels, start, samplesToProcess, coefs, nextCoefs);
+            coefs = nextCoefs;
+        }
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int n = 0; n < numSamples; ++n)
+                expectWithinAbsoluteError (buffer.getSample (ch, n), refBuffer.getSample (ch, n), 1.0e-3f, "Strided output does not match per-sample reference! (stride = " + String (stride) + ")");
+    }
+
+    void doublePrecisionTest()
+    {
+        constexpr int numChannels = 3;
+        constexpr int numSamples = 1000;
+        const auto coefs = MultiChannelShelfFilter::calcCoefs (Decibels::decibelsToGain (6.0f), Decibels::decibelsToGain (-6.0f), 500.0f, 48000.0f);
+
+        auto buffer = makeNoise (numChannels, numSamples);
+        AudioBuffer<double> doubleBuffer (numChannels, numSamples);
+        doubleBuffer.makeCopyOf (buffer);
+
+        MultiChannelShelfFilter filter;
+        filter.prepare (numChannels);
+        filter.process (buffer.getArrayOfWritePointers(), numChannels, 0, numSamples, coefs, coefs);
+
+        // double data (e.g. in the hysteresis oversampling) should be processed the same way
+        MultiChannelShelfFilter doubleFilter;
+        doubleFilter.prepare (numChannels);
+        doubleFilter.process (doubleBuffer.getArrayOfWritePointers(), numChannels, 0, numSamples, coefs, coefs);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int n = 0; n < numSamples; ++n)
+                expectEquals ((float) doubleBuffer.getSample (ch, n), buffer.getSample (ch, n), "Double precision output does not match!");
+    }
+
+    void runTest() override
+    {
+        beginTest ("Reference Test");
+        referenceTest (Decibels::decibelsToGain (6.0f), Decibels::decibelsToGain (-6.0f), 500.0f);
+        referenceTest (Decibels::decibelsToGain (-18.0f), Decibels::decibelsToGain (12.0f), 2000.0f);
+        referenceTest (0.5f, 0.5f, 1000.0f);
+
+        beginTest ("Coefficient Ramp Test");
+        rampTest();
+
+        beginTest ("Coefficient Stride Test");
+        strideTest (1);
+        strideTest (16);
+        strideTest (40);
+
+        beginTest ("Double Precision Test");
+        doublePrecisionTest();
+    }
+};
+
+static ShelfFilterTest shelfFilterTest;
@@ -2,23 +2,47 @@
 
 using namespace MixGroupsConstants;
 
+namespace
+{
+constexpr int pollRateHz = 60;
+
+/**
+ * The parameter that is currently being set from the group on this thread (if any).
+ * I'm changing this param, don't want to get stuck in an endless loop... This is
+ * thread-local, so that changes coming from the host on other threads still get through.
+ */
+struct ParamBeingSetFromGroup
+{
+    const void* controller = nullptr;
+    int paramIndex = -1;
+};
+
+thread_local ParamBeingSetFromGroup paramBeingSetFromGroup;
+} // namespace
+
 MixGroupsController::MixGroupsController (AudioProcessorValueTreeState& vts,
-                                          AudioProcessor* proc) : vts (vts)
+                                          AudioProcessor* proc) : vts (vts),
+                                                                  instanceID (sharedData->getNewInstanceID())
 {
     // load parameters
-    auto params = proc->getParameters();
-    loadParameterList (params);
-
-    // set up receiver
-    sharedData->loadParameterList (paramList);
-    sharedData->addListener (this);
+    auto procParams = proc->getParameters();
+    loadParameterList (procParams);
 
     mixGroupParam = vts.getRawParameterValue (mixGroupParamID);
+
+    startTimerHz (pollRateHz);
 }
 
 MixGroupsController::~MixGroupsController()
 {
-    sharedData->removeListener (this);
+    stopTimer();
+
+    vts.removeParameterListener (mixGroupParamID, this);
+    for (auto* listener : paramListeners)
+        vts.removeParameterListener (params[listener->paramIndex]->paramID, listener);
+
+    if (const auto mixGroup = currentMixGroup.load(); mixGroup > 0)
+        sharedData->leaveGroup (mixGroup);
 }
 
 void MixGroupsController::createParameterLayout (chowdsp::Parameters& params)
@@ -27,85 +51,129 @@ void MixGroupsController::createParameterLayout (chowdsp::Parameters& params)
     emplace_param<chowdsp::ChoiceParameter> (params, mixGroupParamID, "Mix Group", StringArray ({ "N/A", "1", "2", "3", "4" }), 0);
 }
 
-void MixGroupsController::loadParameterList (Array<AudioProcessorParameter*>& params)
+void MixGroupsController::loadParameterList (Array<AudioProcessorParameter*>& procParams)
 {
     // iterate over parameters
-    for (auto* param : params)
+    Array<String> paramList;
+    for (auto* param : procParams)
     {
         auto paramWithID = dynamic_cast<AudioProcessorParameterWithID*> (param);
 
         if (paramWithID == nullptr)
             continue;
 
-        auto paramID = paramWithID->paramID;
-        vts.addParameterListener (paramID, this);
-
-        if (paramID != mixGroupParamID)
-            paramList.addIfNotAlreadyThere (paramID);
+        if (paramWithID->paramID != mixGroupParamID)
+            paramList.addIfNotAlreadyThere (paramWithID->paramID);
     }
-}
 
-void MixGroupsController::parameterChanged (const String& parameterID, float newValue)
-{
-    if (parameterID == lastParameterChanged) // I just changed this param, don't want to get stuck in an endless loop...
+    // every instance has the same parameters, so the first one to get here sets the shared parameter indices
+    sharedData->loadParameterList (paramList);
+    jassert (sharedData->getNumParameters() == paramList.size());
+
+    for (int paramIndex = 0; paramIndex < sharedData->getNumParameters(); ++paramIndex)
     {
-        lastParameterChanged = String();
-        return;
+        const auto& paramID = sharedData->getParameterID (paramIndex);
+        params.add (vts.getParameter (paramID));
+        vts.addParameterListener (paramID, paramListeners.add (std::make_unique<ParameterListener> (*this, paramIndex)));
     }
 
-    int mixGroup = (int) mixGroupParam->load();
+    vts.addParameterListener (mixGroupParamID, this);
+    lastParamVersions.resize ((size_t) params.size(), 0);
+}
 
+void MixGroupsController::parameterChanged (const String& parameterID, float)
+{
     if (parameterID == mixGroupParamID) // mix group was changed
-    {
-        sharedData->pluginGroupChanged (uuid.toString(), mixGroup);
-
-        if (mixGroup == 0)
-            return;
-
-        int numPluginsInGroup = sharedData->getNumPluginsInGroup (mixGroup);
-        if (numPluginsInGroup == 1) // I'm the only plugin in this group
-        {
-            sharedData->copyPluginState (mixGroup, vts);
-        }
-        else if (numPluginsInGroup > 1) // there are already plugins in this group
-        {
-            // copy shared state to me
-            for (const auto& paramID : paramList)
-            {
-                auto param = vts.getParameter (paramID);
-                auto value = sharedData->getParameter (paramID, mixGroup);
-
-                lastParameterChanged = paramID;
-                param->setValueNotifyingHost (param->convertTo0to1 (value));
-            }
-        }
+        changeMixGroup ((int) mixGroupParam->load());
+}
 
+void MixGroupsController::localParameterChanged (int paramIndex, float newValue)
+{
+    const auto mixGroup = currentMixGroup.load();
+    if (mixGroup == 0) // no mix group, don't bother sending
         return;
-    }
 
-    if (mixGroup == 0) // no mix group, don't bother sending
+    if (paramBeingSetFromGroup.controller == this && paramBeingSetFromGroup.paramIndex == paramIndex) // this change came from the group
+        return;
+
+    sharedData->setParameter (paramIndex, mixGroup, newValue, instanceID);
+}
+
+void MixGroupsController::changeMixGroup (int newMixGroup)
+{
+    const auto oldMixGroup = currentMixGroup.exchange (newMixGroup);
+    if (oldMixGroup == newMixGroup)
         return;
 
-    if (! paramList.contains (parameterID)) // parameter is not in list
+    if (oldMixGroup > 0)
+        sharedData->leaveGroup (oldMixGroup);
+
+    if (newMixGroup == 0)
         return;
 
-    sharedData->setParameter (parameterID, mixGroup, newValue, uuid.toString());
+    if (sharedData->joinGroup (newMixGroup) == 1) // I'm the only plugin in this group
+        sharedData->copyPluginState (newMixGroup, vts, instanceID);
+
+    // parameters can only be set on the message thread, otherwise the timer will catch up
+    if (MessageManager::existsAndIsCurrentThread())
+        syncWithGroup (newMixGroup);
+    else
+        needsGroupSync = true;
 }
 
-void MixGroupsController::mixGroupParamChanged (const String& paramID, int mixGroup, float value, String otherUuid)
+void MixGroupsController::syncWithGroup (int mixGroup)
 {
-    if (uuid == otherUuid) // this message came from me!
+    lastGroupVersion = sharedData->getGroupVersion (mixGroup);
+
+    for (int paramIndex = 0; paramIndex < params.size(); ++paramIndex)
+    {
+        const auto state = sharedData->getParameterState (paramIndex, mixGroup);
+        lastParamVersions[(size_t) paramIndex] = state.version;
+
+        if (state.instanceID != instanceID)
+            setParameterFromGroup (paramIndex, state.value);
+    }
+}
+
+void MixGroupsController::timerCallback()
+{
+    const auto mixGroup = currentMixGroup.load();
+    if (mixGroup == 0)
         return;
 
-    // load parameter
-    auto param = vts.getParameter (paramID);
-    if (param == nullptr) // invalid parameter
+    if (needsGroupSync.exchange (false))
+    {
+        syncWithGroup (mixGroup);
+        return;
+    }
+
+    // nothing has changed in the group since last time
+    const auto groupVersion = sharedData->getGroupVersion (mixGroup);
+    if (groupVersion == lastGroupVersion)
         return;
 
-    if (mixGroup != (int) mixGroupParam->load()) // received message does not apply to this mix group
+    lastGroupVersion = groupVersion;
+    for (int paramIndex = 0; paramIndex < params.size(); ++paramIndex)
+    {
+        const auto state = sharedData->getParameterState (paramIndex, mixGroup);
+        if (state.version == lastParamVersions[(size_t) paramIndex])
+            continue;
+
+        lastParamVersions[(size_t) paramIndex] = state.version;
+        if (state.instanceID == instanceID) // this change came from me!
+            continue;
+
+        setParameterFromGroup (paramIndex, state.value);
+    }
+}
+
+void MixGroupsController::setParameterFromGroup (int paramIndex, float value)
+{
+    auto* param = params[paramIndex];
+    if (param == nullptr) // invalid parameter
         return;
 
-    // set parameter value
-    lastParameterChanged = paramID;
+    const auto previous = std::exchange (paramBeingSetFromGroup, { this, paramIndex });
     param->setValueNotifyingHost (param->convertTo0to1 (value));
+    paramBeingSetFromGroup = previous;
 }
@@ -9,9 +9,19 @@ constexpr int numMixGroups = 4;
 const String mixGroupParamID = "mix_group";
 } // namespace MixGroupsConstants
 
-/** Class to control syncing parameters between multiple mix groups */
+/**
+ * Class to control syncing parameters between multiple mix groups.
+ *
+ * Local parameter changes are written straight into the shared
+ * parameter arrays (from whichever thread the host calls from), and a
+ * timer on the message thread polls the group's version counter to
+ * pick up changes made by the other plugins in the group.
+ *
+ * Each parameter has its own small listener that knows the parameter's
+ * index in the shared list, so there's no lookup on every change.
+ */
 class MixGroupsController : private AudioProcessorValueTreeState::Listener,
-                            private MixGroupsSharedData::Listener
+                            private Timer
 {
 public:
     MixGroupsController (AudioProcessorValueTreeState& vts, AudioProcessor* proc);
@@ -20,19 +30,42 @@ public:
     static void createParameterLayout (chowdsp::Parameters& params);
 
     void parameterChanged (const String& parameterID, float newValue) override;
-    void mixGroupParamChanged (const String& paramID, int mixGroup, float value, String otherUuid) override;
 
 private:
+    void timerCallback() override;
+
     void loadParameterList (Array<AudioProcessorParameter*>& params);
+    void localParameterChanged (int paramIndex, float newValue);
+    void changeMixGroup (int newMixGroup);
+
+    /** Copies the group state to this plugin, and marks all the group's changes as seen */
+    void syncWithGroup (int mixGroup);
+    void setParameterFromGroup (int paramIndex, float value);
 
     AudioProcessorValueTreeState& vts;
     std::atomic<float>* mixGroupParam = nullptr;
-    Array<String> paramList;
-    Uuid uuid;
-
-    String lastParameterChanged = "";
 
     SharedResourcePointer<MixGroupsSharedData> sharedData;
+    const uint32 instanceID;
+
+    struct ParameterListener : AudioProcessorValueTreeState::Listener
+    {
+        ParameterListener (MixGroupsController& c, int index) : controller (c), paramIndex (index) {}
+        void parameterChanged (const String&, float newValue) override { controller.localParameterChanged (paramIndex, newValue); }
+
+        MixGroupsController& controller;
+        const int paramIndex;
+    };
+
+    Array<RangedAudioParameter*> params; // in the same order as the shared parameter list
+    OwnedArray<ParameterListener> paramListeners;
+
+    std::atomic<int> currentMixGroup { 0 };
+    std::atomic<bool> needsGroupSync { false };
+
+    // only used on the message thread
+    uint32 lastGroupVersion = 0;
+    std::vector<uint32> lastParamVersions;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MixGroupsController)
 };
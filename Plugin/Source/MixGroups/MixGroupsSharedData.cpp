@@ -1,64 +1,101 @@
 #include "MixGroupsSharedData.h"
 #include "MixGroupsController.h"
 
+namespace
+{
+uint64 packParameter (float value, uint32 instanceID) noexcept
+{
+    uint32 valueBits;
+    std::memcpy (&valueBits, &value, sizeof (float));
+    return ((uint64) instanceID << 32) | (uint64) valueBits;
+}
+
+float unpackValue (uint64 packed) noexcept
+{
+    const auto valueBits = (uint32) (packed & 0xffffffff);
+    float value;
+    std::memcpy (&value, &valueBits, sizeof (float));
+    return value;
+}
+
+uint32 unpackInstanceID (uint64 packed) noexcept
+{
+    return (uint32) (packed >> 32);
+}
+} // namespace
+
 MixGroupsSharedData::MixGroupsSharedData()
 {
     for (int i = 0; i < MixGroupsConstants::numMixGroups; ++i)
-        pluginsInGroup.add (std::make_unique<StringArray>());
+        groups.add (std::make_unique<Group>());
 }
 
-void MixGroupsSharedData::loadParameterList (Array<String>& paramList)
+void MixGroupsSharedData::loadParameterList (const Array<String>& paramList)
 {
-    if (! paramMaps.empty()) // already loaded
+    if (! paramIDs.isEmpty()) // already loaded
         return;
 
-    for (int i = 0; i < MixGroupsConstants::numMixGroups; ++i)
-    {
-        auto paramMap = std::make_unique<ParamMap>();
-
-        for (const auto& paramID : paramList)
-            paramMap->set (paramID, 0.0f);
+    for (auto* group : groups)
+        group->params = std::make_unique<Parameter[]> ((size_t) paramList.size());
 
-        paramMaps.push_back (std::move (paramMap));
-    }
+    for (const auto& paramID : paramList)
+        paramIDs.add (paramID);
 }
 
-void MixGroupsSharedData::pluginGroupChanged (const String& pluginID, int mixGroup)
+int MixGroupsSharedData::joinGroup (int mixGroup) noexcept
 {
-    // remove plugin from any group it's currently in
-    for (auto& group : pluginsInGroup)
-        group->removeString (pluginID);
-
-    if (mixGroup == 0)
-        return;
+    return ++groups[mixGroup - 1]->numPlugins;
+}
 
-    // add plugin to new group
-    pluginsInGroup[mixGroup - 1]->addIfNotAlreadyThere (pluginID);
+void MixGroupsSharedData::leaveGroup (int mixGroup) noexcept
+{
+    --groups[mixGroup - 1]->numPlugins;
 }
 
-int MixGroupsSharedData::getNumPluginsInGroup (int mixGroup) const
+int MixGroupsSharedData::getNumPluginsInGroup (int mixGroup) const noexcept
 {
-    return pluginsInGroup[mixGroup - 1]->size();
+    return groups[mixGroup - 1]->numPlugins.load();
 }
 
-void MixGroupsSharedData::copyPluginState (int mixGroup, AudioProcessorValueTreeState& vts)
+void MixGroupsSharedData::copyPluginState (int mixGroup, AudioProcessorValueTreeState& vts, uint32 instanceID)
 {
-    auto paramMap = paramMaps[(size_t) mixGroup - 1].get();
-    auto mapIter = paramMap->begin();
-    while (mapIter.next())
+    for (int paramIndex = 0; paramIndex < paramIDs.size(); ++paramIndex)
     {
-        const auto param = vts.getRawParameterValue (mapIter.getKey());
-        paramMap->set (mapIter.getKey(), param->load());
+        if (auto* param = vts.getRawParameterValue (paramIDs[paramIndex]))
+            setParameter (paramIndex, mixGroup, param->load(), instanceID);
     }
 }
 
-void MixGroupsSharedData::setParameter (const String& paramID, int mixGroup, float value, String uuid)
+void MixGroupsSharedData::setParameter (int paramIndex, int mixGroup, float value, uint32 instanceID) noexcept
+{
+    // the parameter version is bumped before the group version, so that anyone
+    // who sees the new group version is guaranteed to see the new parameter too
+    auto& param = getParam (paramIndex, mixGroup);
+    param.valueAndInstance.store (packParameter (value, instanceID), std::memory_order_relaxed);
+    param.version.fetch_add (1, std::memory_order_release);
+    groups[mixGroup - 1]->version.fetch_add (1, std::memory_order_release);
+}
+
+float MixGroupsSharedData::getParameter (int paramIndex, int mixGroup) const noexcept
 {
-    paramMaps[(size_t) mixGroup - 1]->set (paramID, value);
-    MessageManager::callAsync ([=] { listeners.call (&Listener::mixGroupParamChanged, paramID, mixGroup, value, uuid); });
+    return getParameterState (paramIndex, mixGroup).value;
+}
+
+MixGroupsSharedData::ParameterState MixGroupsSharedData::getParameterState (int paramIndex, int mixGroup) const noexcept
+{
+    const auto& param = getParam (paramIndex, mixGroup);
+
+    ParameterState state;
+    state.version = param.version.load (std::memory_order_acquire);
+
+    const auto packed = param.valueAndInstance.load (std::memory_order_relaxed);
+    state.value = unpackValue (packed);
+    state.instanceID = unpackInstanceID (packed);
+
+    return state;
 }
 
-float MixGroupsSharedData::getParameter (const String& paramID, int mixGroup) const
+uint32 MixGroupsSharedData::getGroupVersion (int mixGroup) const noexcept
 {
-    return paramMaps[(size_t) mixGroup - 1]->operator[] (paramID);
+    return groups[mixGroup - 1]->version.load (std::memory_order_acquire);
 }
@@ -1,44 +1,94 @@
 #ifndef MIXGROUPSPARAMRECEIVER
 #define MIXGROUPSPARAMRECEIVER
 
-#include <JuceHeader.h>
+#include "SharedModulationBuffer.h"
 
+/**
+ * Parameter state shared between all the plugin instances in a mix group.
+ *
+ * Parameters are referred to by an integer index (the order of the list
+ * passed to loadParameterList()), and each group stores its parameter values
+ * in an array of atomics, so any instance can read or write them from any
+ * thread without locking. Every write bumps a version counter for the
+ * parameter and for the group, so instances can cheaply poll for changes.
+ *
+ * Each group also has buffers for sharing modulation signals (see SharedModulationBuffer).
+ */
 class MixGroupsSharedData
 {
 public:
     MixGroupsSharedData();
 
-    /** Create parameter maps from list of parameters */
-    void loadParameterList (Array<String>& paramList);
+    /** Create the parameter arrays from a list of parameter IDs (only the first call does anything) */
+    void loadParameterList (const Array<String>& paramList);
 
-    /** A plugin has changed mix group. */
-    void pluginGroupChanged (const String& pluginID, int mixGroup);
+    /** Returns the number of shared parameters */
+    int getNumParameters() const noexcept { return paramIDs.size(); }
+
+    /** Returns the ID of the parameter with the given index */
+    const String& getParameterID (int paramIndex) const { return paramIDs.getReference (paramIndex); }
+
+    /** Returns a new ID that a plugin instance can use to mark its parameter changes */
+    uint32 getNewInstanceID() noexcept { return ++lastInstanceID; }
+
+    /** A plugin has joined a mix group. Returns the number of plugins now in the group. */
+    int joinGroup (int mixGroup) noexcept;
+
+    /** A plugin has left a mix group */
+    void leaveGroup (int mixGroup) noexcept;
 
     /** Get the number of plugins already in this mix group */
-    int getNumPluginsInGroup (int mixGroup) const;
+    int getNumPluginsInGroup (int mixGroup) const noexcept;
 
-    /** Copy the plugin state into the parameter map for a given mix group */
-    void copyPluginState (int mixGroup, AudioProcessorValueTreeState& vts);
+    /** Copy the plugin state into the parameter array for a given mix group */
+    void copyPluginState (int mixGroup, AudioProcessorValueTreeState& vts, uint32 instanceID);
 
-    void setParameter (const String& paramID, int mixGroup, float value, String uuid);
-    float getParameter (const String& paramID, int mixGroup) const;
+    void setParameter (int paramIndex, int mixGroup, float value, uint32 instanceID) noexcept;
+    float getParameter (int paramIndex, int mixGroup) const noexcept;
 
-    struct Listener
+    /** The latest value of a parameter, along with the instance that set it */
+    struct ParameterState
     {
-        virtual ~Listener() {}
-        virtual void mixGroupParamChanged (const String& /*paramID*/, int /*mixGroup*/, float /*value*/, String /*uuid*/) {}
+        float value = 0.0f;
+        uint32 instanceID = 0;
+        uint32 version = 0;
     };
 
-    void addListener (Listener* l) { listeners.add (l); }
-    void removeListener (Listener* l) { listeners.remove (l); }
+    ParameterState getParameterState (int paramIndex, int mixGroup) const noexcept;
+
+    /** Returns a counter that changes whenever any parameter in the group is changed */
+    uint32 getGroupVersion (int mixGroup) const noexcept;
+
+    /** Modulation signals that can be shared by all the plugins in a group */
+    struct GroupModulation
+    {
+        SharedModulationBuffer<2> wow; // { LFO, depth offset }
+        SharedModulationBuffer<1> flutter;
+    };
+
+    GroupModulation& getModulation (int mixGroup) noexcept { return groups[mixGroup - 1]->modulation; }
 
 private:
-    using ParamMap = HashMap<String, float>;
-    std::vector<std::unique_ptr<ParamMap>> paramMaps;
+    struct Parameter
+    {
+        std::atomic<uint64> valueAndInstance { 0 }; // instance ID in the upper 32 bits, float value bits in the lower 32
+        std::atomic<uint32> version { 0 };
+    };
+
+    struct Group
+    {
+        std::unique_ptr<Parameter[]> params;
+        std::atomic<uint32> version { 0 };
+        std::atomic<int> numPlugins { 0 };
+        GroupModulation modulation;
+    };
+
+    Parameter& getParam (int paramIndex, int mixGroup) const noexcept { return groups[mixGroup - 1]->params[(size_t) paramIndex]; }
 
-    OwnedArray<StringArray> pluginsInGroup; // list of plugin IDs of all the plugins in each mix group
+    StringArray paramIDs;
+    OwnedArray<Group> groups;
 
-    ListenerList<Listener> listeners;
+    std::atomic<uint32> lastInstanceID { 0 };
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MixGroupsSharedData)
 };
@@ -0,0 +1,169 @@
+#ifndef SHAREDMODULATIONBUFFER_H_INCLUDED
+#define SHAREDMODULATIONBUFFER_H_INCLUDED
+
+#include <JuceHeader.h>
+
+/**
+ * Lock-free ring buffer of control-rate modulation frames, shared by the
+ * plugins in a mix group. One plugin (the group "leader") generates the
+ * modulation and pushes it into the buffer, and the rest of the group
+ * pops it back out, so the whole group gets the same modulation for the
+ * cost of computing it once.
+ *
+ * Each plugin talks to the buffer through its own Client, from its audio thread.
+ */
+template <size_t numSignals>
+class SharedModulationBuffer
+{
+public:
+    using Frame = std::array<float, numSignals>;
+
+    static constexpr int bufferSize = 1 << 13; // in control-rate frames
+
+    SharedModulationBuffer() = default;
+
+    class Client
+    {
+    public:
+        Client() = default;
+        ~Client() { setBuffer (nullptr, 0); }
+
+        /** Sets the largest number of frames that will be needed for one block */
+        void prepare (int maxFramesPerBlock) noexcept
+        {
+            // the followers read this far behind the leader, so it doesn't
+            // matter which order the host processes the plugins in
+            readLatency = 2 * maxFramesPerBlock;
+            needsResync = true;
+        }
+
+        /** Sets the buffer to share modulation through, or nullptr to stop sharing */
+        void setBuffer (SharedModulationBuffer* newBuffer, uint32 newInstanceID) noexcept
+        {
+            if (newBuffer == buffer)
+                return;
+
+            if (buffer != nullptr) // hand over the leadership to whoever gets there next
+            {
+                auto expected = instanceID;
+                buffer->leaderID.compare_exchange_strong (expected, 0);
+            }
+
+            buffer = newBuffer;
+            instanceID = newInstanceID;
+            isLeader = false;
+            numStaleBlocks = 0;
+            needsResync = true;
+        }
+
+        bool isSharing() const noexcept { return buffer != nullptr; }
+
+        /**
+         * Called at the start of each block. Returns true if this plugin should
+         * generate its own modulation (and push() it), or false if it should pop()
+         * the modulation that was generated by the group leader.
+         */
+        bool beginBlock (double controlRate, int numFrames) noexcept
+        {
+            const auto writePosition = buffer->writePosition.load (std::memory_order_acquire);
+
+            // if the leader has stopped writing (e.g. the host has stopped processing it), take over
+            numStaleBlocks = writePosition == lastWritePosition ? numStaleBlocks + 1 : 0;
+            lastWritePosition = writePosition;
+
+            isLeader = claimLeadership (numStaleBlocks > maxStaleBlocks);
+            if (isLeader)
+            {
+                buffer->controlRate.store (controlRate);
+                leaderWritePosition = writePosition;
+                numStaleBlocks = 0;
+                return true;
+            }
+
+            // the leader is running at a different sample rate, so we can't use its modulation
+            if (buffer->controlRate.load() != controlRate)
+                return true;
+
+            const auto numAvailable = writePosition - readPosition;
+            if (needsResync || numAvailable < numFrames || numAvailable > bufferSize / 2)
+            {
+                readPosition = jmax ((int64) 0, writePosition - readLatency);
+                needsResync = false;
+            }
+
+            return false;
+        }
+
+        /** Called at the end of each block, to publish any frames that have been pushed */
+        void endBlock() noexcept
+        {
+            if (isLeader)
+                buffer->writePosition.store (leaderWritePosition, std::memory_order_release);
+        }
+
+        /** Pushes a newly generated frame to the rest of the group (if this plugin is the leader) */
+        inline Frame push (const Frame& frame) noexcept
+        {
+            if (isLeader)
+            {
+                auto& slot = buffer->frames[(size_t) (leaderWritePosition++ & (bufferSize - 1))];
+                for (size_t i = 0; i < numSignals; ++i)
+                    slot[i].store (frame[i], std::memory_order_relaxed);
+            }
+
+            return frame;
+        }
+
+        /** Pops the next frame generated by the group leader (or repeats the last frame if there's none available) */
+        inline Frame pop() noexcept
+        {
+            if (readPosition < buffer->writePosition.load (std::memory_order_acquire))
+            {
+                const auto& slot = buffer->frames[(size_t) (readPosition++ & (bufferSize - 1))];
+                for (size_t i = 0; i < numSignals; ++i)
+                    lastFrame[i] = slot[i].load (std::memory_order_relaxed);
+            }
+
+            return lastFrame;
+        }
+
+    private:
+        bool claimLeadership (bool leaderIsStale) noexcept
+        {
+            auto leader = buffer->leaderID.load();
+            if (leader == instanceID)
+                return true;
+
+            if (leader != 0 && ! leaderIsStale)
+                return false;
+
+            return buffer->leaderID.compare_exchange_strong (leader, instanceID);
+        }
+
+        static constexpr int maxStaleBlocks = 8;
+
+        SharedModulationBuffer* buffer = nullptr;
+        uint32 instanceID = 0;
+        bool isLeader = false;
+
+        int64 leaderWritePosition = 0;
+        int64 readPosition = 0;
+        int64 lastWritePosition = -1;
+        int64 readLatency = 0;
+        int numStaleBlocks = 0;
+        bool needsResync = true;
+        Frame lastFrame {};
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Client)
+    };
+
+private:
+    std::array<std::array<std::atomic<float>, numSignals>, bufferSize> frames {};
+    std::atomic<int64> writePosition { 0 };
+    std::atomic<uint32> leaderID { 0 }; // zero if there's no leader
+    std::atomic<double> controlRate { 0.0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SharedModulationBuffer)
+};
+
+#endif // SHAREDMODULATIONBUFFER_H_INCLUDED
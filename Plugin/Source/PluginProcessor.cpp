@@ -36,26 +36,35 @@ const String dryWetTag = "drywet";
 } // namespace
 
 //==============================================================================
-ChowtapeModelAudioProcessor::ChowtapeModelAudioProcessor() : inputFilters (vts),
+ChowtapeModelAudioProcessor::ChowtapeModelAudioProcessor() : inputFilters (vts, bypassManager, backBypassManager),
                                                              midSideController (vts),
                                                              toneControl (vts),
-                                                             compressionProcessor (vts),
-                                                             hysteresis (vts),
-                                                             degrade (vts),
-                                                             chewer (vts),
-                                                             lossFilter (vts),
-                                                             flutter (vts),
+                                                             compressionProcessor (vts, bypassManager),
+                                                             hysteresis (vts, bypassManager),
+                                                             degrade (vts, backBypassManager),
+                                                             chewer (vts, backBypassManager),
+                                                             lossFilter (vts, backBypassManager),
+                                                             flutter (vts, backBypassManager),
                                                              onOffManager (vts, this),
                                                              mixGroupsController (vts, this)
 {
     pluginSettings->initialise (settingsFilePath);
+    pluginSettings->addProperties ({ { parallelChannelsID, false }, { pipelinedID, false }, { sharedModulationID, false } }, this);
+    globalSettingChanged (parallelChannelsID);
+    globalSettingChanged (pipelinedID);
+    globalSettingChanged (sharedModulationID);
 
     chowdsp::ParamUtils::loadParameterPointer (inGainDBParam, vts, inGainTag);
     chowdsp::ParamUtils::loadParameterPointer (outGainDBParam, vts, outGainTag);
     chowdsp::ParamUtils::loadParameterPointer (dryWetParam, vts, dryWetTag);
+    hysteresisOnOffParam = vts.getRawParameterValue ("hyst_onoff");
+    compressionOnOffParam = vts.getRawParameterValue ("comp_onoff");
+    lossOnOffParam = vts.getRawParameterValue ("loss_onoff");
 
     presetManager = std::make_unique<PresetManager> (vts);
 
+    sharedOSStages = [this] (dsp::AudioBlock<double>& osBlock, int osFactor) { processSharedOSStages (osBlock, osFactor); };
+
     positionInfo.bpm = 120.0;
     positionInfo.timeSigNumerator = 4;
 
@@ -71,6 +80,66 @@ ChowtapeModelAudioProcessor::ChowtapeModelAudioProcessor() : inputFilters (vts),
         toneControl.setDBScale (18.0f);
 }
 
+ChowtapeModelAudioProcessor::~ChowtapeModelAudioProcessor()
+{
+    pluginSettings->removePropertyListener (this);
+}
+
+void ChowtapeModelAudioProcessor::globalSettingChanged (SettingID settingID)
+{
+    if (settingID == parallelChannelsID)
+    {
+        // the worker threads are started/stopped while the host is not processing
+        suspendProcessing (true);
+        hysteresis.setParallelChannelProcessing (getGlobalSetting (parallelChannelsID));
+        suspendProcessing (false);
+        return;
+    }
+
+    if (settingID == sharedModulationID)
+    {
+        flutter.setGroupModulationSharing (getGlobalSetting (sharedModulationID));
+        return;
+    }
+
+    if (settingID == pipelinedID)
+    {
+        const auto shouldBePipelined = getGlobalSetting (pipelinedID);
+        if (shouldBePipelined == isPipelined)
+            return;
+
+        // the pipeline is re-configured while the host is not processing
+        suspendProcessing (true);
+        isPipelined = shouldBePipelined;
+        pipelineWorker.start (isPipelined ? 1 : 0);
+        resetPipeline();
+        if (getBlockSize() > 0) // otherwise, the latency will be updated in prepareToPlay()
+            updateLatency();
+        suspendProcessing (false);
+    }
+}
+
+void ChowtapeModelAudioProcessor::setRandomSeed (uint64 seed)
+{
+    degrade.setSeed (seed);
+    chewer.setSeed (seed + 1);
+    flutter.setSeed (seed + 2);
+}
+
+bool ChowtapeModelAudioProcessor::getGlobalSetting (SettingID settingID) const
+{
+    if (const auto overrideIter = settingOverrides.find (settingID); overrideIter != settingOverrides.end())
+        return overrideIter->second;
+
+    return pluginSettings->getProperty<bool> (settingID);
+}
+
+void ChowtapeModelAudioProcessor::overrideGlobalSetting (SettingID settingID, bool value)
+{
+    settingOverrides[settingID] = value;
+    globalSettingChanged (settingID);
+}
+
 void ChowtapeModelAudioProcessor::addParameters (Parameters& params)
 {
     using namespace chowdsp::ParamUtils;
@@ -94,6 +163,12 @@ void ChowtapeModelAudioProcessor::prepareToPlay (double sampleRate, int samplesP
 {
     const auto numChannels = getTotalNumInputChannels();
     setRateAndBufferSizeDetails (sampleRate, samplesPerBlock);
+    isPrepared = true;
+
+    // room for one bypass fade, plus one nested inside it (the compressor switching its oversampling on/off),
+    // all at the base rate (the compressor fades inside the shared oversampling without any snapshots)
+    bypassManager.prepare (samplesPerBlock * 2, numChannels);
+    backBypassManager.prepare (samplesPerBlock, numChannels);
 
     inGain.prepareToPlay (sampleRate, samplesPerBlock);
     inputFilters.prepareToPlay (sampleRate, samplesPerBlock, numChannels);
@@ -106,7 +181,6 @@ void ChowtapeModelAudioProcessor::prepareToPlay (double sampleRate, int samplesP
     lossFilter.prepare ((float) sampleRate, samplesPerBlock, numChannels);
 
     dryDelay.prepare ({ sampleRate, (uint32) samplesPerBlock, (uint32) numChannels });
-    dryDelay.setDelay (calcLatencySamples());
 
     flutter.prepareToPlay (sampleRate, samplesPerBlock, numChannels);
     outGain.prepareToPlay (sampleRate, samplesPerBlock);
@@ -116,15 +190,34 @@ void ChowtapeModelAudioProcessor::prepareToPlay (double sampleRate, int samplesP
 
     dryWet.setDryWet (*vts.getRawParameterValue ("drywet") / 100.0f);
     dryWet.reset();
-    dryBuffer.setSize (numChannels, samplesPerBlock);
 
-    setLatencySamples (roundToInt (calcLatencySamples()));
+    for (auto& slot : pipelineSlots)
+    {
+        slot.dry.setSize (numChannels, samplesPerBlock);
+        slot.wet.setSize (numChannels, samplesPerBlock);
+    }
+    pipelineOutput.setSize (numChannels, 2 * samplesPerBlock + 1);
+    pipelineOutputFifo.setTotalSize (2 * samplesPerBlock + 1);
+    pipelineWorker.setParkTime ((double) samplesPerBlock / sampleRate);
+    resetPipeline();
+
+    latencyState = getLatencyState();
+    updateLatency();
+    dryDelay.setDelay (latencySamples);
+
     magicState.getPropertyAsValue (isStereoTag).setValue (numChannels == 2);
 }
 
 void ChowtapeModelAudioProcessor::releaseResources()
 {
     hysteresis.releaseResources();
+    isPrepared = false;
+}
+
+void ChowtapeModelAudioProcessor::setLatencyChangedCallback (std::function<void (float)>&& callback)
+{
+    jassert (! isPrepared); // the audio thread might be calling the old callback!
+    latencyChangedCallback = std::move (callback);
 }
 
 float ChowtapeModelAudioProcessor::calcLatencySamples() const noexcept
@@ -144,9 +237,19 @@ void ChowtapeModelAudioProcessor::processBlockBypassed (AudioBuffer<float>& buff
 {
     ScopedNoDenormals noDenormals;
 
-    dryBuffer.makeCopyOf (buffer, true);
+    // finish off the block that's still in the pipeline, so that the output stays one block behind
+    if (isPipelined)
+        processPipelineBackSlot (1 - pipelineSlotIndex);
+
+    dryWet.pushDry (dryDelay, buffer, true);
     latencyCompensation();
-    buffer.makeCopyOf (dryBuffer, true);
+    dryWet.popDry (dryDelay, buffer);
+
+    if (isPipelined)
+    {
+        writePipelineOutput (buffer, buffer.getNumSamples());
+        readPipelineOutput (buffer);
+    }
 }
 
 void ChowtapeModelAudioProcessor::processAudioBlock (AudioBuffer<float>& buffer)
@@ -155,58 +258,226 @@ void ChowtapeModelAudioProcessor::processAudioBlock (AudioBuffer<float>& buffer)
         playhead->getCurrentPosition (positionInfo);
 
     inGain.setGain (Decibels::decibelsToGain (inGainDBParam->getCurrentValue()));
+
+    // each stage is wrapped in a profiler probe, which just calls through unless CHOWTAPE_PROFILER is enabled
+    profiler.beginBlock (buffer.getNumSamples());
+    if (isPipelined)
+    {
+        processPipelined (buffer);
+    }
+    else
+    {
+        updateOutputGains();
+        profiler.probe (StageProfiler::Output, [&] { dryWet.pushDry (dryDelay, buffer); });
+        processFrontHalf (buffer, 0);
+        processBackHalf (buffer, 0, false);
+    }
+    profiler.endBlock();
+}
+
+void ChowtapeModelAudioProcessor::updateOutputGains()
+{
     outGain.setGain (Decibels::decibelsToGain (outGainDBParam->getCurrentValue()));
     dryWet.setDryWet (dryWetParam->getCurrentValue());
+}
 
-    dryBuffer.makeCopyOf (buffer, true);
-    inGain.processBlock (buffer);
-    inputFilters.processBlock (buffer);
+void ChowtapeModelAudioProcessor::processFrontHalf (AudioBuffer<float>& buffer, int slot)
+{
+    bypassManager.beginBlock();
+    profiler.probe (StageProfiler::InputGain, [&] { inGain.processBlock (buffer); });
+    profiler.probe (StageProfiler::InputFilters, [&] { inputFilters.processBlock (buffer, slot); });
 
     scope->pushSamplesIO (buffer, TapeScope::AudioType::Input);
 
-    midSideController.processInput (buffer);
-    toneControl.processBlockIn (buffer);
-    compressionProcessor.processBlock (buffer);
-    hysteresis.processBlock (buffer);
-    toneControl.processBlockOut (buffer);
-    chewer.processBlock (buffer);
-    degrade.processBlock (buffer);
-    flutter.processBlock (buffer);
-    lossFilter.processBlock (buffer);
+    profiler.probe (StageProfiler::MidSide, [&] { midSideController.processInput (buffer, slot); });
+    if (hysteresis.isOversamplingShared())
+    {
+        profiler.probe (StageProfiler::Hysteresis, [&] { hysteresis.processBlock (buffer, sharedOSStages); });
+    }
+    else
+    {
+        profiler.probe (StageProfiler::Tone, [&] { toneControl.processBlockIn (buffer); });
+        profiler.probe (StageProfiler::Compression, [&] { compressionProcessor.processBlock (buffer); });
+        profiler.probe (StageProfiler::Hysteresis, [&] { hysteresis.processBlock (buffer); });
+    }
+}
+
+void ChowtapeModelAudioProcessor::processBackHalf (AudioBuffer<float>& buffer, int slot, bool isPipelinedBlock)
+{
+    // the profiler can only be used from the audio thread, so the pipelined back half isn't profiled
+    auto probe = [this, isPipelinedBlock] (StageProfiler::Stage stage, auto&& stageFunc) {
+        if (isPipelinedBlock)
+            stageFunc();
+        else
+            profiler.probe (stage, stageFunc);
+    };
+
+    backBypassManager.beginBlock();
+    probe (StageProfiler::Tone, [&] { toneControl.processBlockOut (buffer); });
+    probe (StageProfiler::Chew, [&] { chewer.processBlock (buffer); });
+    probe (StageProfiler::Degrade, [&] { degrade.processBlock (buffer); });
+    probe (StageProfiler::WowFlutter, [&] { flutter.processBlock (buffer); });
+    probe (StageProfiler::Loss, [&] { lossFilter.processBlock (buffer); });
+
+    // (when pipelined, this is done back on the audio thread)
+    if (! isPipelinedBlock)
+        latencyCompensation();
+
+    probe (StageProfiler::MidSide, [&] { midSideController.processOutput (buffer, slot); });
+    probe (StageProfiler::InputFilters, [&] { inputFilters.processBlockMakeup (buffer, slot); });
+
+    // final mix: output gain, delayed dry signal, and dry/wet, all in one pass
+    probe (StageProfiler::Output, [&] {
+        const auto [outGainStart, outGainEnd] = outGain.getNextBlockGains();
+        dryWet.processBlock (dryDelay, buffer, outGainStart, outGainEnd);
+    });
+
+    // (when pipelined, this is done back on the audio thread, after the join)
+    if (! isPipelinedBlock)
+        scope->pushSamplesIO (buffer, TapeScope::AudioType::Output);
+}
+
+void ChowtapeModelAudioProcessor::processPipelined (AudioBuffer<float>& buffer)
+{
+    const auto numChannels = buffer.getNumChannels();
+    const auto numSamples = buffer.getNumSamples();
+    const auto frontSlot = pipelineSlotIndex;
+    const auto backSlot = 1 - pipelineSlotIndex;
+    auto& front = pipelineSlots[(size_t) frontSlot];
+
+    // the dry signal is kept until the back half gets to this block
+    for (int ch = 0; ch < numChannels; ++ch)
+        front.dry.copyFrom (ch, 0, buffer, ch, 0, numSamples);
+
+    // the front half processes this block on the audio thread, while the back half processes the previous block on the worker
+    auto stageTask = [&] (int task) {
+        if (task == 0)
+            processFrontHalf (buffer, frontSlot);
+        else
+            processPipelineBackSlot (backSlot);
+    };
+    pipelineWorker.parallelFor (2, stageTask);
 
     latencyCompensation();
 
-    midSideController.processOutput (buffer);
-    inputFilters.processBlockMakeup (buffer);
-    outGain.processBlock (buffer);
-    dryWet.processBlock (dryBuffer, buffer);
+    for (int ch = 0; ch < numChannels; ++ch)
+        front.wet.copyFrom (ch, 0, buffer, ch, 0, numSamples);
+    front.numSamples = numSamples;
 
+    readPipelineOutput (buffer);
+    pipelineSlotIndex = backSlot;
+
+    // the scope is only fed from the audio thread, so the input and output pushes can't race
     scope->pushSamplesIO (buffer, TapeScope::AudioType::Output);
 }
 
-void ChowtapeModelAudioProcessor::latencyCompensation()
+void ChowtapeModelAudioProcessor::processPipelineBackSlot (int slot)
 {
-    // delay dry buffer to avoid phase issues
-    const auto latencySampFloat = calcLatencySamples();
-    const auto latencySamp = roundToInt (latencySampFloat);
-    setLatencySamples (latencySamp);
+    auto& pipelineSlot = pipelineSlots[(size_t) slot];
+    if (pipelineSlot.numSamples == 0)
+        return;
+
+    const auto numChannels = pipelineSlot.wet.getNumChannels();
+    AudioBuffer<float> dryBuffer (pipelineSlot.dry.getArrayOfWritePointers(), numChannels, pipelineSlot.numSamples);
+    AudioBuffer<float> wetBuffer (pipelineSlot.wet.getArrayOfWritePointers(), numChannels, pipelineSlot.numSamples);
+
+    updateOutputGains();
+    dryWet.pushDry (dryDelay, dryBuffer);
+    processBackHalf (wetBuffer, slot, true);
+
+    writePipelineOutput (wetBuffer, pipelineSlot.numSamples);
+    pipelineSlot.numSamples = 0;
+}
+
+void ChowtapeModelAudioProcessor::writePipelineOutput (const AudioBuffer<float>& buffer, int numSamples)
+{
+    const auto scope = pipelineOutputFifo.write (numSamples);
+    jassert (scope.blockSize1 + scope.blockSize2 == numSamples); // not enough room in the FIFO!
+
+    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+    {
+        pipelineOutput.copyFrom (ch, scope.startIndex1, buffer, ch, 0, scope.blockSize1);
+        pipelineOutput.copyFrom (ch, scope.startIndex2, buffer, ch, scope.blockSize1, scope.blockSize2);
+    }
+}
+
+void ChowtapeModelAudioProcessor::readPipelineOutput (AudioBuffer<float>& buffer)
+{
+    const auto numSamples = buffer.getNumSamples();
+    const auto scope = pipelineOutputFifo.read (numSamples);
+    jassert (scope.blockSize1 + scope.blockSize2 == numSamples); // the output should always be one block ahead!
+
+    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+    {
+        buffer.copyFrom (ch, 0, pipelineOutput, ch, scope.startIndex1, scope.blockSize1);
+        buffer.copyFrom (ch, scope.blockSize1, pipelineOutput, ch, scope.startIndex2, scope.blockSize2);
+    }
+}
+
+void ChowtapeModelAudioProcessor::resetPipeline()
+{
+    for (auto& slot : pipelineSlots)
+        slot.numSamples = 0;
+    pipelineSlotIndex = 0;
+
+    // the output starts out one block behind
+    pipelineOutput.clear();
+    pipelineOutputFifo.reset();
+    if (isPipelined)
+        pipelineOutputFifo.finishedWrite (jmin (getBlockSize(), pipelineOutputFifo.getFreeSpace()));
+}
+
+void ChowtapeModelAudioProcessor::processSharedOSStages (dsp::AudioBlock<double>& osBlock, int osFactor)
+{
+    // both stages work on the (double precision) oversampled block in place, so there's no block-sized conversion here
+    profiler.probe (StageProfiler::Tone, [&] { toneControl.processBlockIn (osBlock, osFactor); });
+    profiler.probe (StageProfiler::Compression, [&] { compressionProcessor.processOversampledBlock (osBlock, osFactor); });
+}
+
+ChowtapeModelAudioProcessor::LatencyState ChowtapeModelAudioProcessor::getLatencyState() const noexcept
+{
+    return { hysteresisOnOffParam->load() == 1.0f,
+             compressionOnOffParam->load() == 1.0f,
+             lossOnOffParam->load() == 1.0f,
+             compressionProcessor.isUsingSharedOversampling(),
+             hysteresis.getOversamplingRevision() };
+}
+
+void ChowtapeModelAudioProcessor::updateLatency()
+{
+    // the dry signal goes through the pipeline as well, so only the reported latency includes the pipeline delay
+    latencySamples = calcLatencySamples();
+    const auto pipelineLatency = getPipelineLatencySamples();
+    setLatencySamples (roundToInt (latencySamples) + pipelineLatency);
 
     // delay makeup block from input filters
-    inputFilters.setMakeupDelay (latencySampFloat);
+    inputFilters.setMakeupDelay (latencySamples);
 
+    if (latencyChangedCallback != nullptr)
+        latencyChangedCallback (latencySamples + (float) pipelineLatency);
+}
+
+void ChowtapeModelAudioProcessor::latencyCompensation()
+{
+    // the latency only needs to be re-computed (and reported to the host) when something it depends on has changed
+    const auto newLatencyState = getLatencyState();
+    if (newLatencyState != latencyState)
+    {
+        latencyState = newLatencyState;
+        updateLatency();
+    }
+
+    // delay dry buffer to avoid phase issues
     // For "true bypass" use integer sample delay to avoid delay
     // line interpolation freq. response issues
     if (dryWet.getDryWet() < 0.15f)
     {
-        dryDelay.setDelay ((float) latencySamp);
+        dryDelay.setDelay ((float) roundToInt (latencySamples));
     }
     else
     {
-        dryDelay.setDelay (latencySampFloat);
+        dryDelay.setDelay (latencySamples);
     }
-
-    dsp::AudioBlock<float> block { dryBuffer };
-    dryDelay.process (dsp::ProcessContextReplacing<float> { block });
 }
 
 AudioProcessorEditor* ChowtapeModelAudioProcessor::createEditor()
@@ -318,6 +589,16 @@ void ChowtapeModelAudioProcessor::setStateInformation (const void* data, int siz
     }
 }
 
+bool ChowtapeModelAudioProcessor::loadPresetFromFile (const File& presetFile)
+{
+    auto preset = static_cast<PresetManager&> (*presetManager).loadUserPresetFromFile (presetFile);
+    if (! preset.isValid())
+        return false;
+
+    presetManager->loadPreset (preset);
+    return true;
+}
+
 // This creates new instances of the plugin..
 AudioProcessor* JUCE_CALLTYPE createPluginFilter()
 {
@@ -22,8 +22,11 @@
 #include "Processors/Hysteresis/HysteresisProcessor.h"
 #include "Processors/Hysteresis/ToneControl.h"
 #include "Processors/Input_Filters/InputFilters.h"
+#include "Processors/LatencyDelayLine.h"
 #include "Processors/Loss_Effects/LossFilter.h"
 #include "Processors/MidSide/MidSideProcessor.h"
+#include "Processors/RealtimeWorkerPool.h"
+#include "Processors/StageProfiler.h"
 #include "Processors/Timing_Effects/WowFlutterProcessor.h"
 
 #if HAS_CLAP_JUCE_EXTENSIONS
@@ -36,10 +39,14 @@ JUCE_END_IGNORE_WARNINGS_GCC_LIKE
 #include "GUI/AutoUpdating.h"
 #endif
 
-class ChowtapeModelAudioProcessor : public chowdsp::PluginBase<ChowtapeModelAudioProcessor>
+class ChowtapeModelAudioProcessor : public chowdsp::PluginBase<ChowtapeModelAudioProcessor>,
+                                    private chowdsp::GlobalPluginSettings::Listener
 {
+    using SettingID = chowdsp::GlobalPluginSettings::SettingID;
+
 public:
     ChowtapeModelAudioProcessor();
+    ~ChowtapeModelAudioProcessor() override;
 
     static void addParameters (Parameters& params);
 
@@ -52,27 +59,105 @@ public:
     void processBlockBypassed (AudioBuffer<float>&, MidiBuffer&) override;
     float calcLatencySamples() const noexcept;
 
+    /**
+     * Sets a callback for whenever the plugin latency changes, which is called with the un-rounded
+     * latency in samples. The callback is usually called on the audio thread, so it can only be set
+     * while the plugin is not prepared (i.e. before prepareToPlay(), or after releaseResources()).
+     */
+    void setLatencyChangedCallback (std::function<void (float)>&& callback);
+
     AudioProcessorEditor* createEditor() override;
 
     void getStateInformation (MemoryBlock& destData) override;
     void setStateInformation (const void* data, int sizeInBytes) override;
 
+    /** Loads a preset from a .chowpreset file. Returns false if the file is not a valid preset. */
+    bool loadPresetFromFile (const File& presetFile);
+
+    /**
+     * Sets the seed for all the random processes (degrade noise and variance, chew, and wow drift/variance),
+     * so that offline renders are reproducible. The seed takes effect the next time prepareToPlay() is called.
+     *
+     * The seed is not saved with the plugin state: otherwise, duplicating a track would duplicate the seed, and the
+     * noise on the two tracks would be fully correlated. Instead, each instance starts with its own random seed,
+     * unless it's pinned with this method (e.g. by the headless batch renderer).
+     */
+    void setRandomSeed (uint64 seed);
+
     const AudioProcessorValueTreeState& getVTS() const { return vts; }
     AudioProcessorValueTreeState& getVTS() { return vts; }
     const AudioPlayHead::CurrentPositionInfo& getPositionInfo() const { return positionInfo; }
     auto* getOpenGLHelper() { return openGLHelper.get(); }
     auto& getOversampling() { return hysteresis.getOSManager(); }
+    StageProfiler& getStageProfiler() { return profiler; }
+    const StageProfiler& getStageProfiler() const { return profiler; }
+
+    /** Global setting for processing the channels of wide (more than stereo) layouts in parallel */
+    static constexpr SettingID parallelChannelsID = "parallel_channels";
+
+    /** Global setting for pipelining the processing chain across two threads, at the cost of one block of latency */
+    static constexpr SettingID pipelinedID = "pipelined_processing";
+
+    /** Global setting for generating the wow/flutter once per mix group, and sharing it between the plugins in the group */
+    static constexpr SettingID sharedModulationID = "mix_group_shared_modulation";
+
+    /**
+     * Overrides one of the global settings for this instance only (e.g. for testing, or offline rendering),
+     * without touching the user's settings file, or any other instances. Must not be called while processing!
+     */
+    void overrideGlobalSetting (SettingID settingID, bool value);
 
 private:
-    using DryDelayType = chowdsp::DelayLine<float, chowdsp::DelayLineInterpolationTypes::Lagrange5th>;
+    void globalSettingChanged (SettingID settingID) override;
+    bool getGlobalSetting (SettingID settingID) const;
     void latencyCompensation();
+    void updateLatency();
+    void processSharedOSStages (dsp::AudioBlock<double>& osBlock, int osFactor);
+    void updateOutputGains();
+    void processFrontHalf (AudioBuffer<float>& buffer, int slot);
+    void processBackHalf (AudioBuffer<float>& buffer, int slot, bool isPipelinedBlock);
+
+    void processPipelined (AudioBuffer<float>& buffer);
+    void processPipelineBackSlot (int slot);
+    void readPipelineOutput (AudioBuffer<float>& buffer);
+    void writePipelineOutput (const AudioBuffer<float>& buffer, int numSamples);
+    void resetPipeline();
+    int getPipelineLatencySamples() const noexcept { return isPipelined ? getBlockSize() : 0; }
 
     chowdsp::SharedPluginSettings pluginSettings;
+    std::map<SettingID, bool> settingOverrides;
 
     chowdsp::FloatParameter* inGainDBParam = nullptr;
     chowdsp::FloatParameter* outGainDBParam = nullptr;
     chowdsp::FloatParameter* dryWetParam = nullptr;
 
+    /** Everything the plugin latency depends on, so it only needs to be re-computed when one of these changes */
+    struct LatencyState
+    {
+        bool hysteresisOn = false;
+        bool compressionOn = false;
+        bool lossOn = false;
+        bool compressionSharedOS = false;
+        int osRevision = -1;
+
+        bool operator!= (const LatencyState& other) const noexcept
+        {
+            return std::tie (hysteresisOn, compressionOn, lossOn, compressionSharedOS, osRevision)
+                   != std::tie (other.hysteresisOn, other.compressionOn, other.lossOn, other.compressionSharedOS, other.osRevision);
+        }
+    };
+
+    LatencyState getLatencyState() const noexcept;
+    std::function<void (float)> latencyChangedCallback;
+    std::atomic<bool> isPrepared { false };
+    LatencyState latencyState;
+    float latencySamples = 0.0f;
+    std::atomic<float>* hysteresisOnOffParam = nullptr;
+    std::atomic<float>* compressionOnOffParam = nullptr;
+    std::atomic<float>* lossOnOffParam = nullptr;
+
+    BypassManager bypassManager; // for the front half of the chain (up to the hysteresis)
+    BypassManager backBypassManager; // for the back half of the chain
     GainProcessor inGain;
     InputFilters inputFilters;
     MidSideProcessor midSideController;
@@ -84,11 +169,31 @@ private:
     LossFilter lossFilter;
     WowFlutterProcessor flutter;
     DryWetProcessor dryWet;
-    DryDelayType dryDelay { 1 << 21 };
+    LatencyDelayLine dryDelay { 1 << 21 };
     GainProcessor outGain;
     OnOffManager onOffManager;
-
-    AudioBuffer<float> dryBuffer;
+    StageProfiler profiler;
+
+    // tone-in and compression can run inside the hysteresis oversampling
+    HysteresisProcessor::OversampledStage sharedOSStages;
+
+    // When pipelined, the front half of the chain processes each block on the audio thread,
+    // while the back half processes the previous block on a worker thread. The output is
+    // then read from a FIFO that starts out one (max size) block behind.
+    struct PipelineSlot
+    {
+        AudioBuffer<float> dry, wet;
+        int numSamples = 0; // zero if there's no block waiting for the back half
+    };
+
+    static constexpr int numPipelineSlots = 2;
+    static_assert (numPipelineSlots == InputFilters::numSlots && numPipelineSlots == MidSideProcessor::numSlots);
+    std::array<PipelineSlot, numPipelineSlots> pipelineSlots;
+    int pipelineSlotIndex = 0;
+    AudioBuffer<float> pipelineOutput;
+    AbstractFifo pipelineOutputFifo { 1 };
+    RealtimeWorkerPool pipelineWorker { "ChowTape Pipeline Worker" };
+    bool isPipelined = false; // only changed while processing is suspended
 
     foleys::MagicProcessorState magicState { *this, vts };
     TapeScope* scope = nullptr;
@@ -163,7 +163,7 @@ chowdsp::Preset PresetManager::loadUserPresetFromFile (const File& file)
 
 void PresetManager::loadPresetState (const XmlElement* xml)
 {
-    StringArray presetAgnosticParams { "os_factor", "os_mode", "os_render_factor", "os_render_mode", "os_render_like_realtime" };
+    StringArray presetAgnosticParams { "os_factor", "os_mode", "os_render_factor", "os_render_mode", "os_render_like_realtime", "os_shared" };
 
     auto newState = juce::ValueTree::fromXml (*xml);
     for (auto& param : presetAgnosticParams)
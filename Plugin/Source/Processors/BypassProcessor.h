@@ -3,22 +3,91 @@
 
 #include <JuceHeader.h>
 
+/**
+ * Shared memory for the bypass crossfades of all the processors in the chain.
+ *
+ * Rather than every processor owning a fade buffer, snapshots are taken
+ * from one stack-like memory block, which is released again once the
+ * crossfade is finished. Snapshots may be nested (e.g. for processors
+ * running inside another processor's oversampling), as long as they are
+ * released in reverse order.
+ */
+class BypassManager
+{
+public:
+    BypassManager() = default;
+
+    struct Snapshot
+    {
+        const float* getReadPointer (int channel) const noexcept { return data + channel * numSamples; }
+
+        float* data = nullptr;
+        int numSamples = 0;
+        size_t offset = 0;
+    };
+
+    /** Allocates room for maxNumSamples samples (in total, for all nested snapshots) of numChannels channels */
+    void prepare (int maxNumSamples, int numChannels)
+    {
+        capacity = (size_t) maxNumSamples * (size_t) numChannels;
+        memory.allocate (capacity, true);
+        used = 0;
+    }
+
+    /** Releases any snapshots that were left over from the last block */
+    void beginBlock() noexcept { used = 0; }
+
+    /** Copies the buffer into the shared memory. Returns an empty snapshot if there's not enough room. */
+    Snapshot takeSnapshot (const AudioBuffer<float>& buffer) noexcept
+    {
+        const auto numChannels = buffer.getNumChannels();
+        const auto numSamples = buffer.getNumSamples();
+        const auto size = (size_t) numChannels * (size_t) numSamples;
+        if (used + size > capacity)
+        {
+            jassertfalse; // not enough memory was prepared!
+            return {};
+        }
+
+        Snapshot snapshot { memory.get() + used, numSamples, used };
+        for (int ch = 0; ch < numChannels; ++ch)
+            FloatVectorOperations::copy (snapshot.data + ch * numSamples, buffer.getReadPointer (ch), numSamples);
+
+        used += size;
+        return snapshot;
+    }
+
+    /** Releases a snapshot, along with anything taken after it */
+    void release (const Snapshot& snapshot) noexcept
+    {
+        if (snapshot.data != nullptr)
+            used = snapshot.offset;
+    }
+
+private:
+    HeapBlock<float> memory;
+    size_t capacity = 0;
+    size_t used = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BypassManager)
+};
+
 /** Utility class for *smoothly* bypassing a processor */
 class BypassProcessor
 {
 public:
-    BypassProcessor() = default;
+    explicit BypassProcessor (BypassManager& bypassManager) : manager (bypassManager) {}
 
     static bool toBool (const std::atomic<float>* param)
     {
         return static_cast<bool> (param->load());
     }
 
-    void prepare (int samplesPerBlock, int numChannels, bool onOffParam)
+    void prepare (bool onOffParam)
     {
         prevOnOffParam = onOffParam;
-        fadeBuffer.setSize (numChannels, samplesPerBlock);
-        bufferCopied = false;
+        fadeRequested = false;
+        snapshot = {};
     }
 
     /**
@@ -26,28 +95,43 @@ public:
       * If it returns false, you can safely skip all other
       * processing.
       */
-    bool processBlockIn (AudioBuffer<float>& block, bool onOffParam)
+    bool processBlockIn (const AudioBuffer<float>& block, bool onOffParam)
     {
         if (! onOffParam && ! prevOnOffParam)
             return false; // NOLINT
 
         if (onOffParam != prevOnOffParam)
         {
-            fadeBuffer.makeCopyOf (block, true);
-            bufferCopied = true;
+            snapshot = manager.takeSnapshot (block);
+            fadeRequested = true;
         }
 
         return true;
     }
 
+    /** Call this at the end of your processBlock(), if processBlockIn() returned true */
     void processBlockOut (AudioBuffer<float>& block, bool onOffParam)
     {
-        if (onOffParam == prevOnOffParam)
-            return;
-
-        if (! bufferCopied)
+        if (! fadeRequested)
             return; // parameter was changed in the middle of the buffer, let's wait for the next one!
 
+        fadeRequested = false;
+        if (onOffParam != prevOnOffParam)
+        {
+            // if no snapshot could be taken, we just switch without fading
+            if (snapshot.data != nullptr)
+                crossfade (block, onOffParam);
+
+            prevOnOffParam = onOffParam;
+        }
+
+        manager.release (snapshot);
+        snapshot = {};
+    }
+
+private:
+    void crossfade (AudioBuffer<float>& block, bool onOffParam) const
+    {
         const auto numChannels = block.getNumChannels();
         const auto numSamples = block.getNumSamples();
 
@@ -57,16 +141,13 @@ public:
 
         block.applyGainRamp (0, numSamples, startGain, endGain);
         for (int ch = 0; ch < numChannels; ++ch)
-            block.addFromWithRamp (ch, 0, fadeBuffer.getReadPointer (ch), numSamples, 1.0f - startGain, 1.0f - endGain);
-
-        prevOnOffParam = onOffParam;
-        bufferCopied = false;
+            block.addFromWithRamp (ch, 0, snapshot.getReadPointer (ch), numSamples, 1.0f - startGain, 1.0f - endGain);
     }
 
-private:
+    BypassManager& manager;
+    BypassManager::Snapshot snapshot;
     bool prevOnOffParam = false;
-    bool bufferCopied = false;
-    AudioBuffer<float> fadeBuffer;
+    bool fadeRequested = false;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BypassProcessor)
 };
@@ -1,6 +1,6 @@
 #include "ChewProcessor.h"
 
-ChewProcessor::ChewProcessor (AudioProcessorValueTreeState& vts)
+ChewProcessor::ChewProcessor (AudioProcessorValueTreeState& vts, BypassManager& bypassManager) : bypass (bypassManager)
 {
     using namespace chowdsp::ParamUtils;
     loadParameterPointer (depth, vts, "chew_depth");
@@ -21,6 +21,7 @@ void ChewProcessor::createParameterLayout (chowdsp::Parameters& params)
 void ChewProcessor::prepare (double sr, int samplesPerBlock, int numChannels)
 {
     sampleRate = (float) sr;
+    random.setSeed ((int64) seed);
 
     dropout.prepare (sr, numChannels);
 
@@ -32,7 +33,7 @@ void ChewProcessor::prepare (double sr, int samplesPerBlock, int numChannels)
     samplesUntilChange = getDryTime();
     sampleCounter = 0;
 
-    bypass.prepare (samplesPerBlock, numChannels, bypass.toBool (onOff));
+    bypass.prepare (bypass.toBool (onOff));
 }
 
 void ChewProcessor::processBlock (AudioBuffer<float>& buffer)
@@ -128,9 +129,18 @@ void ChewProcessor::processShortBlock (AudioBuffer<float>& buffer)
     dropout.setMix (mix);
     dropout.setPower (1.0f + power);
 
-    dropout.process (buffer);
-    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
-        filt[ch].process (buffer.getWritePointer (ch), buffer.getNumSamples());
+    // dropout and filter each channel while the short block is still in cache
+    const auto numSamples = buffer.getNumSamples();
+    const auto dropoutActive = dropout.isActive();
+    for (size_t ch = 0; ch < (size_t) buffer.getNumChannels(); ++ch)
+    {
+        auto* x = buffer.getWritePointer ((int) ch);
+
+        if (dropoutActive)
+            dropout.processChannel (x, numSamples, ch);
+
+        filt[ch].processSubRate (x, numSamples);
+    }
 
     sampleCounter += buffer.getNumSamples();
 }
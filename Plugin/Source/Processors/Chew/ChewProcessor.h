@@ -8,11 +8,14 @@
 class ChewProcessor
 {
 public:
-    ChewProcessor (AudioProcessorValueTreeState& vts);
+    ChewProcessor (AudioProcessorValueTreeState& vts, BypassManager& bypassManager);
 
     static void createParameterLayout (chowdsp::Parameters& params);
 
     void prepare (double sr, int samplesPerBlock, int numChannels);
+
+    /** Sets the seed for the chew timing and power, which takes effect the next time prepare() is called */
+    void setSeed (uint64 newSeed) noexcept { seed = newSeed; }
     void processBlock (AudioBuffer<float>& buffer);
     void processShortBlock (AudioBuffer<float>& buffer);
 
@@ -28,6 +31,7 @@ private:
     std::vector<DegradeFilter> filt;
 
     Random random;
+    uint64 seed = (uint64) Random::getSystemRandom().nextInt64();
     int samplesUntilChange = 1000;
     bool isCrinkled = false;
     int sampleCounter = 0;
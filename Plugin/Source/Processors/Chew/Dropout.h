@@ -2,6 +2,7 @@
 #define DROPOUT_H_INCLUDED
 
 #include "JuceHeader.h"
+#include <xsimd/xsimd.hpp>
 
 class Dropout
 {
@@ -31,29 +32,70 @@ public:
             power.reset (sr, 0.005);
     }
 
-    void process (AudioBuffer<float>& buffer)
+    /** Returns false if the dropout is fully mixed out, and can be skipped */
+    bool isActive() const noexcept
     {
-        if (mixSmooth[0].getTargetValue() == 0.0f && ! mixSmooth[0].isSmoothing())
-            return;
+        return mixSmooth[0].getTargetValue() != 0.0f || mixSmooth[0].isSmoothing();
+    }
 
-        for (size_t ch = 0; ch < (size_t) buffer.getNumChannels(); ++ch)
-        {
-            auto* x = buffer.getWritePointer ((int) ch);
-            for (int n = 0; n < buffer.getNumSamples(); ++n)
-            {
-                auto mix = mixSmooth[ch].getNextValue();
-                x[n] = mix * dropout (x[n], ch) + (1.0f - mix) * x[n];
-            }
-        }
+    void processChannel (float* x, int numSamples, size_t ch) noexcept
+    {
+        for (int n = 0; n < numSamples; n += maxBlockSize)
+            processChunk (x + n, jmin (maxBlockSize, numSamples - n), ch);
     }
 
-    inline float dropout (float x, size_t ch)
+    /** Scalar version of the dropout curve: sign(x) * |x|^power */
+    static inline float dropout (float x, float power) noexcept
     {
         auto sign = (float) chowdsp::Math::sign (x);
-        return pow (abs (x), powerSmooth[ch].getNextValue()) * sign;
+        return std::pow (std::abs (x), power) * sign;
     }
 
 private:
+    static constexpr int maxBlockSize = 64;
+
+    template <typename SmoothType>
+    static void fillSmoothed (SmoothType& smoother, float* data, int numSamples) noexcept
+    {
+        if (! smoother.isSmoothing())
+        {
+            std::fill (data, data + numSamples, smoother.getTargetValue());
+            return;
+        }
+
+        for (int n = 0; n < numSamples; ++n)
+            data[n] = smoother.getNextValue();
+    }
+
+    /** Applies the dropout curve to a chunk of samples, using a vectorized exp/log power function */
+    void processChunk (float* x, int numSamples, size_t ch) noexcept
+    {
+        using Vec = xsimd::batch<float>;
+        constexpr auto vecSize = (int) Vec::size;
+
+        float mixData[maxBlockSize];
+        float powerData[maxBlockSize];
+        fillSmoothed (mixSmooth[ch], mixData, numSamples);
+        fillSmoothed (powerSmooth[ch], powerData, numSamples);
+
+        int n = 0;
+        for (; n + vecSize <= numSamples; n += vecSize)
+        {
+            const auto xVec = xsimd::load_unaligned (x + n);
+            const auto mix = xsimd::load_unaligned (mixData + n);
+            const auto power = xsimd::load_unaligned (powerData + n);
+
+            auto y = xsimd::pow (xsimd::abs (xVec), power);
+            y = xsimd::select (xVec < 0.0f, -y, y);
+
+            xsimd::store_unaligned (x + n, mix * y + (1.0f - mix) * xVec);
+        }
+
+        // remaining samples that can't be vectorized
+        for (; n < numSamples; ++n)
+            x[n] = mixData[n] * dropout (x[n], powerData[n]) + (1.0f - mixData[n]) * x[n];
+    }
+
     std::vector<LinearSmoothedValue<float>> mixSmooth;
     std::vector<LinearSmoothedValue<float>> powerSmooth;
 
@@ -1,6 +1,7 @@
 #include "CompressionProcessor.h"
 
-CompressionProcessor::CompressionProcessor (AudioProcessorValueTreeState& vts)
+CompressionProcessor::CompressionProcessor (AudioProcessorValueTreeState& vts, BypassManager& bypassMgr) : bypass (bypassMgr),
+                                                                                                           bypassManager (bypassMgr)
 {
     using namespace chowdsp::ParamUtils;
     onOff = vts.getRawParameterValue ("comp_onoff");
@@ -20,24 +21,33 @@ void CompressionProcessor::createParameterLayout (chowdsp::Parameters& params)
 
 void CompressionProcessor::prepare (double sr, int samplesPerBlock, int numChannels)
 {
-    oversample = std::make_unique<dsp::Oversampling<float>> (numChannels, 1, dsp::Oversampling<float>::filterHalfBandPolyphaseIIR, true, true);
-    oversample->initProcessing ((size_t) samplesPerBlock);
-    auto osFactor = oversample->getOversamplingFactor();
-    bypass.prepare (samplesPerBlock, numChannels, bypass.toBool (onOff));
+    fs = sr;
+    detectorRate = sr;
+    usingSharedOS = false;
 
-    slewLimiter.clear();
-    dbPlusSmooth.clear();
-    for (int ch = 0; ch < numChannels; ++ch)
+    // the oversampler can only be re-used if the channel count is unchanged
+    if (oversample == nullptr || oversampleNumChannels != numChannels)
     {
-        slewLimiter.emplace_back();
-        dbPlusSmooth.emplace_back();
-
-        slewLimiter[ch].prepare ({ sr, (uint32) samplesPerBlock, 1 });
-        dbPlusSmooth[ch].reset (sr, 0.05);
+        oversample = std::make_unique<dsp::Oversampling<float>> (numChannels, 1, dsp::Oversampling<float>::filterHalfBandPolyphaseIIR, true, true);
+        oversampleNumChannels = numChannels;
     }
+    oversample->initProcessing ((size_t) samplesPerBlock);
+
+    passThroughDelay.prepare ({ sr, (uint32) samplesPerBlock, (uint32) numChannels });
+    passThroughDelay.setDelay (oversample->getLatencyInSamples());
+    warmupHistory.setSize (numChannels, jmin (maxWarmupSamples, samplesPerBlock));
+    warmupHistory.clear();
+    wasFlat = false;
+
+    bypass.prepare (bypass.toBool (onOff));
+
+    slewLimiter.prepare (sr, numChannels);
+    dbPlusSmooth.reset (sr, 0.05);
 
-    xDBVec.resize (osFactor * (size_t) samplesPerBlock, 0.0f);
-    compGainVec.resize (osFactor * (size_t) samplesPerBlock, 0.0f);
+    dbPlusData.resize ((size_t) chunkSize, 0.0f);
+    detectorData.resize ((size_t) chunkSize, 0.0f);
+    gainData.resize ((size_t) chunkSize, 0.0f);
+    interleavedGain.resize ((size_t) (chunkSize * GainSlewLimiter::laneCount), 1.0f);
 }
 
 template <typename T>
@@ -54,61 +64,258 @@ inline T compressionDB (const T& xDB, float dbPlus)
     return select (belowWin, (T) dbPlus, log (xDB + window + 1.0f) - dbPlus - xDB);
 }
 
-void CompressionProcessor::processBlock (AudioBuffer<float>& buffer)
+void CompressionProcessor::computeGain (const float* x, float* gain, int numSamples) noexcept
 {
-    if (! bypass.processBlockIn (buffer, bypass.toBool (onOff)))
+    constexpr auto inc = (int) xsimd::batch<float>::size;
+    int n = 0;
+    for (; n + inc <= numSamples; n += inc)
+    {
+        auto xDB = chowdsp::SIMDUtils::gainToDecibels (xsimd::abs (xsimd::load_unaligned (x + n)));
+        auto compDB = compressionDB (xDB, dbPlusData[size_t (n + inc - 1)]);
+        xsimd::store_aligned (gain + n, chowdsp::SIMDUtils::decibelsToGain (compDB));
+    }
+
+    // remaining samples that can't be vectorized
+    for (; n < numSamples; ++n)
+    {
+        auto xDB = Decibels::gainToDecibels (std::abs (x[n]));
+        gain[n] = Decibels::decibelsToGain (compressionDB (xDB, dbPlusData[(size_t) n]));
+    }
+}
+
+bool CompressionProcessor::isGainCurveFlat() const noexcept
+{
+    // with no compression amount, compressionDB() is 0 dB for any input
+    return dbPlusSmooth.getTargetValue() <= 0.0f && ! dbPlusSmooth.isSmoothing() && slewLimiter.isSettledAtUnity();
+}
+
+void CompressionProcessor::setDetectorSampleRate (double newDetectorRate)
+{
+    if (newDetectorRate == detectorRate)
         return;
 
-    dsp::AudioBlock<float> block (buffer);
-    auto osBlock = oversample->processSamplesUp (block);
+    detectorRate = newDetectorRate;
+    slewLimiter.setSampleRate (detectorRate);
+    dbPlusSmooth.reset (detectorRate, 0.05);
+}
 
-    const auto numSamples = (int) osBlock.getNumSamples();
-    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+void CompressionProcessor::processOversampledBlock (dsp::AudioBlock<double>& osBlock, int osFactor)
+{
+    // Rather than crossfading with a snapshot of the (oversampled) input, the on/off
+    // fade is done by ramping the compression gain to/from unity, so no fade memory
+    // is needed at the oversampled rate. The bypass processor is just kept in sync,
+    // for when we go back to our own oversampling.
+    const auto isOn = bypass.toBool (onOff);
+    const auto wasOn = usingSharedOS ? wasOnInSharedOS : isOn; // (no fade when switching into the shared oversampling)
+    wasOnInSharedOS = isOn;
+    usingSharedOS = true;
+    bypass.prepare (isOn);
+    if (! isOn && ! wasOn)
+        return;
+
+    // The detector ballistics are tuned for the compressor's own 2x oversampling,
+    // so here we scale the detector rate to keep the same time constants.
+    setDetectorSampleRate (fs * (double) osFactor / 2.0);
+    dbPlusSmooth.setTargetValue (amountParam->getCurrentValue());
+
+    // with no oversampling to skip, the flat gain curve is just a no-op
+    if (! isGainCurveFlat())
+        applyCompression (osBlock, wasOn ? 1.0f : 0.0f, isOn ? 1.0f : 0.0f);
+}
+
+void CompressionProcessor::processBlock (AudioBuffer<float>& buffer)
+{
+    if (std::exchange (usingSharedOS, false))
     {
-        dbPlusSmooth[ch].setTargetValue (amountParam->getCurrentValue());
+        // coming back from the shared oversampling, so our own processing state is stale
+        oversample->reset();
+        passThroughDelay.reset();
+        wasFlat = false;
+    }
 
-        auto* x = osBlock.getChannelPointer ((size_t) ch);
-        FloatVectorOperations::copy (xDBVec.data(), x, numSamples);
-        FloatVectorOperations::abs (xDBVec.data(), xDBVec.data(), numSamples);
+    if (! bypass.processBlockIn (buffer, bypass.toBool (onOff)))
+        return;
 
-        constexpr auto inc = xsimd::batch<float>::size;
-        size_t n = 0;
-        for (; n < (size_t) numSamples; n += inc)
-        {
-            auto xDB = xsimd::load_aligned (&xDBVec[n]);
+    setDetectorSampleRate (fs);
+    dbPlusSmooth.setTargetValue (amountParam->getCurrentValue());
 
-            xDB = chowdsp::SIMDUtils::gainToDecibels (xDB);
-            auto compDB = compressionDB (xDB, dbPlusSmooth[ch].skip ((int) inc));
-            auto compGain = chowdsp::SIMDUtils::decibelsToGain (compDB);
+    processCompression (buffer);
 
-            xsimd::store_aligned (&xDBVec[n], xDB);
-            xsimd::store_aligned (&compGainVec[n], compGain);
-        }
+    bypass.processBlockOut (buffer, bypass.toBool (onOff));
+}
 
-        // remaining samples that can't be vectorized
-        for (; n < (size_t) numSamples; ++n)
+void CompressionProcessor::processCompression (AudioBuffer<float>& buffer)
+{
+    const auto numChannels = buffer.getNumChannels();
+    const auto numSamples = buffer.getNumSamples();
+    const auto isFlat = isGainCurveFlat();
+    if (isFlat)
+        updateWarmupHistory (buffer);
+
+    if (isFlat && wasFlat)
+    {
+        // With a flat gain curve, there's no gain to compute or apply, so we
+        // skip the oversampling, and just delay the signal by the same latency.
+        for (int ch = 0; ch < numChannels; ++ch)
+            processPassThrough (buffer.getWritePointer (ch), ch, numSamples);
+        return;
+    }
+
+    if (isFlat == wasFlat)
+    {
+        // the pass-through delay is kept running, so it's ready to take over at any time
+        for (int ch = 0; ch < numChannels; ++ch)
         {
-            xDBVec[n] = Decibels::gainToDecibels (xDBVec[n]);
-            auto compDB = compressionDB (xDBVec[n], dbPlusSmooth[ch].getNextValue());
-            compGainVec[n] = Decibels::decibelsToGain (compDB);
+            const auto* x = buffer.getReadPointer (ch);
+            for (int n = 0; n < numSamples; ++n)
+            {
+                passThroughDelay.pushSample (ch, x[n]);
+                passThroughDelay.popSample (ch);
+            }
         }
 
-        // since the slew will be applied to the gain, we need to reverse the attack and release parameters!
-        slewLimiter[ch].setParameters (releaseParam->getCurrentValue(), attackParam->getCurrentValue());
-        for (size_t k = 0; k < (size_t) numSamples; ++k)
-            compGainVec[k] = jmin (compGainVec[k], slewLimiter[ch].processSample (compGainVec[k]));
+        processOversampled (buffer, isFlat);
+        return;
+    }
+
+    // The pass-through delay doesn't have quite the same phase response as the oversampling filters,
+    // so while switching paths, both are run, and crossfaded over one block (only while the gain
+    // is at unity, so the two paths are as close as they can be).
+    if (! isFlat)
+        warmUpOversampler();
+
+    auto passThrough = bypassManager.takeSnapshot (buffer);
+    if (passThrough.data != nullptr) // (if there's no room for the snapshot, we just switch without fading)
+        for (int ch = 0; ch < numChannels; ++ch)
+            processPassThrough (passThrough.data + ch * numSamples, ch, numSamples);
 
-        FloatVectorOperations::multiply (x, compGainVec.data(), numSamples);
+    processOversampled (buffer, isFlat);
+
+    if (passThrough.data != nullptr)
+    {
+        const auto startGain = isFlat ? 1.0f : 0.0f; // gain of the oversampled path
+        buffer.applyGainRamp (0, numSamples, startGain, 1.0f - startGain);
+        for (int ch = 0; ch < numChannels; ++ch)
+            buffer.addFromWithRamp (ch, 0, passThrough.getReadPointer (ch), numSamples, 1.0f - startGain, startGain);
     }
 
+    bypassManager.release (passThrough);
+    wasFlat = isFlat;
+}
+
+void CompressionProcessor::processOversampled (AudioBuffer<float>& buffer, bool isFlat)
+{
+    dsp::AudioBlock<float> block (buffer);
+    auto osBlock = oversample->processSamplesUp (block);
+
+    if (! isFlat)
+        applyCompression (osBlock);
+
     oversample->processSamplesDown (block);
+}
 
-    bypass.processBlockOut (buffer, bypass.toBool (onOff));
+void CompressionProcessor::processPassThrough (float* x, int channel, int numSamples) noexcept
+{
+    for (int n = 0; n < numSamples; ++n)
+        passThroughDelay.pushSample (channel, x[n]);
+
+    for (int n = 0; n < numSamples; ++n)
+        x[n] = passThroughDelay.popSample (channel);
+}
+
+void CompressionProcessor::updateWarmupHistory (const AudioBuffer<float>& buffer)
+{
+    const auto historySize = warmupHistory.getNumSamples();
+    const auto numSamples = jmin (buffer.getNumSamples(), historySize);
+    for (int ch = 0; ch < warmupHistory.getNumChannels(); ++ch)
+    {
+        auto* history = warmupHistory.getWritePointer (ch);
+        std::copy (history + numSamples, history + historySize, history); // shift out the oldest samples
+        FloatVectorOperations::copy (history + historySize - numSamples, buffer.getReadPointer (ch, buffer.getNumSamples() - numSamples), numSamples);
+    }
+}
+
+void CompressionProcessor::warmUpOversampler()
+{
+    // the oversampling filters haven't seen the signal for a while, so we run them over the
+    // most recent input (and throw away the output), so they don't start from a stale state
+    oversample->reset();
+    dsp::AudioBlock<float> historyBlock (warmupHistory);
+    oversample->processSamplesUp (historyBlock);
+    oversample->processSamplesDown (historyBlock);
+}
+
+template <typename SampleType>
+void CompressionProcessor::applyCompression (dsp::AudioBlock<SampleType>& osBlock, float mixStart, float mixEnd)
+{
+    // since the slew will be applied to the gain, we need to reverse the attack and release parameters!
+    slewLimiter.setParameters (releaseParam->getCurrentValue(), attackParam->getCurrentValue());
+
+    // Detection, gain computer, slew, and gain application all happen
+    // in one pass, over chunks that are small enough to stay in cache.
+    constexpr auto laneCount = GainSlewLimiter::laneCount;
+    const auto numSamples = (int) osBlock.getNumSamples();
+    const auto numChannels = (int) osBlock.getNumChannels();
+    for (int start = 0; start < numSamples; start += chunkSize)
+    {
+        const auto samplesToProcess = jmin (chunkSize, numSamples - start);
+        for (int n = 0; n < samplesToProcess; ++n)
+            dbPlusData[(size_t) n] = dbPlusSmooth.getNextValue();
+
+        for (size_t group = 0; group < GainSlewLimiter::getNumGroups (numChannels); ++group)
+        {
+            const auto groupStartChannel = (int) group * laneCount;
+            const auto channelsInGroup = jmin (laneCount, numChannels - groupStartChannel);
+
+            for (int lane = 0; lane < channelsInGroup; ++lane)
+            {
+                const auto* x = osBlock.getChannelPointer (size_t (groupStartChannel + lane)) + start;
+                if constexpr (std::is_same_v<SampleType, float>)
+                {
+                    computeGain (x, gainData.data(), samplesToProcess);
+                }
+                else
+                {
+                    // the gain computer runs in single precision, so only the detector input is converted
+                    for (int n = 0; n < samplesToProcess; ++n)
+                        detectorData[(size_t) n] = (float) x[n];
+                    computeGain (detectorData.data(), gainData.data(), samplesToProcess);
+                }
+
+                for (int n = 0; n < samplesToProcess; ++n)
+                    interleavedGain[size_t (n * laneCount + lane)] = gainData[(size_t) n];
+            }
+
+            slewLimiter.process (interleavedGain.data(), samplesToProcess, group);
+
+            // fading the compression in or out: mix the gain with unity
+            if (mixStart != 1.0f || mixEnd != 1.0f)
+            {
+                const auto mixInc = (mixEnd - mixStart) / (float) numSamples;
+                for (int n = 0; n < samplesToProcess; ++n)
+                {
+                    const auto mix = mixStart + mixInc * (float) (start + n);
+                    for (int lane = 0; lane < laneCount; ++lane)
+                    {
+                        auto& gain = interleavedGain[size_t (n * laneCount + lane)];
+                        gain = 1.0f + (gain - 1.0f) * mix;
+                    }
+                }
+            }
+
+            for (int lane = 0; lane < channelsInGroup; ++lane)
+            {
+                auto* x = osBlock.getChannelPointer (size_t (groupStartChannel + lane)) + start;
+                for (int n = 0; n < samplesToProcess; ++n)
+                    x[n] *= (SampleType) interleavedGain[size_t (n * laneCount + lane)];
+            }
+        }
+    }
 }
 
 float CompressionProcessor::getLatencySamples() const noexcept
 {
-    if (oversample == nullptr)
+    if (oversample == nullptr || usingSharedOS)
         return 0.0f;
 
     return onOff->load() == 1.0f ? oversample->getLatencyInSamples() // on
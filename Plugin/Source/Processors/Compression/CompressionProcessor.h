@@ -2,35 +2,68 @@
 #define COMPRESSIONPROCESSOR_H_INCLUDED
 
 #include "../BypassProcessor.h"
-#include <xsimd/xsimd.hpp>
+#include "../LatencyDelayLine.h"
+#include "GainSlewLimiter.h"
 
 class CompressionProcessor
 {
 public:
-    CompressionProcessor (AudioProcessorValueTreeState& vts);
+    CompressionProcessor (AudioProcessorValueTreeState& vts, BypassManager& bypassManager);
 
     static void createParameterLayout (chowdsp::Parameters& params);
 
     void prepare (double sr, int samplesPerBlock, int numChannels);
     void processBlock (AudioBuffer<float>& buffer);
 
+    /** Processes a block that has already been oversampled by osFactor (see HysteresisProcessor::OversampledStage) */
+    void processOversampledBlock (dsp::AudioBlock<double>& osBlock, int osFactor);
+
     float getLatencySamples() const noexcept;
+    bool isUsingSharedOversampling() const noexcept { return usingSharedOS; }
 
 private:
+    bool isGainCurveFlat() const noexcept;
+    void processCompression (AudioBuffer<float>& buffer);
+    void processOversampled (AudioBuffer<float>& buffer, bool isFlat);
+    void processPassThrough (float* x, int channel, int numSamples) noexcept;
+    void updateWarmupHistory (const AudioBuffer<float>& buffer);
+    void warmUpOversampler();
+    template <typename SampleType>
+    void applyCompression (dsp::AudioBlock<SampleType>& osBlock, float mixStart = 1.0f, float mixEnd = 1.0f);
+    void setDetectorSampleRate (double newDetectorRate);
+    void computeGain (const float* x, float* gain, int numSamples) noexcept;
+
     std::atomic<float>* onOff = nullptr;
     chowdsp::FloatParameter* amountParam = nullptr;
     chowdsp::FloatParameter* attackParam = nullptr;
     chowdsp::FloatParameter* releaseParam = nullptr;
 
-    std::vector<chowdsp::LevelDetector<float>> slewLimiter;
+    GainSlewLimiter slewLimiter;
     BypassProcessor bypass;
 
+    BypassManager& bypassManager;
     std::unique_ptr<dsp::Oversampling<float>> oversample;
+    int oversampleNumChannels = 0;
+
+    // with a flat gain curve, the signal is just delayed by the oversampling latency
+    LatencyDelayLine passThroughDelay { 16 };
+    AudioBuffer<float> warmupHistory; // the most recent input, for warming up the oversampler when it's needed again
+    static constexpr int maxWarmupSamples = 64;
+    bool wasFlat = false;
+
+    // when running in a shared oversampling domain, the oversampler is not used
+    bool usingSharedOS = false;
+    bool wasOnInSharedOS = false;
+    double fs = 48000.0;
+    double detectorRate = 48000.0;
 
-    std::vector<SmoothedValue<float, ValueSmoothingTypes::Linear>> dbPlusSmooth;
+    SmoothedValue<float, ValueSmoothingTypes::Linear> dbPlusSmooth;
 
-    std::vector<float, xsimd::aligned_allocator<float>> xDBVec;
-    std::vector<float, xsimd::aligned_allocator<float>> compGainVec;
+    static constexpr int chunkSize = 64;
+    std::vector<float, xsimd::aligned_allocator<float>> dbPlusData;
+    std::vector<float, xsimd::aligned_allocator<float>> detectorData; // the detector input, when processing in double
+    std::vector<float, xsimd::aligned_allocator<float>> gainData;
+    std::vector<float, xsimd::aligned_allocator<float>> interleavedGain;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CompressionProcessor)
 };
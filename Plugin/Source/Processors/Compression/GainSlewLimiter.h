@@ -0,0 +1,99 @@
+#ifndef GAINSLEWLIMITER_H_INCLUDED
+#define GAINSLEWLIMITER_H_INCLUDED
+
+#include <JuceHeader.h>
+#include <xsimd/xsimd.hpp>
+
+/**
+ * Slew limiter for the compressor gain, with the same ballistics as
+ * chowdsp::LevelDetector.
+ *
+ * The recursion can't be vectorized in time, so instead each channel
+ * gets one lane of a SIMD register, and the gain data is expected to be
+ * interleaved in groups of laneCount channels.
+ */
+class GainSlewLimiter
+{
+public:
+    using Vec = xsimd::batch<float>;
+    static constexpr auto laneCount = (int) Vec::size;
+
+    GainSlewLimiter() = default;
+
+    void prepare (double sampleRate, int numChannels)
+    {
+        setSampleRate (sampleRate);
+        numActiveChannels = numChannels;
+        state.clear();
+        state.resize (getNumGroups (numChannels), Vec (0.0f));
+    }
+
+    /** Changes the sample rate without resetting the slew state. Call setParameters() afterwards! */
+    void setSampleRate (double sampleRate) noexcept
+    {
+        expFactor = -2.0f * MathConstants<float>::pi * 1000.0f / (float) sampleRate;
+    }
+
+    static size_t getNumGroups (int numChannels) noexcept
+    {
+        return chowdsp::Math::ceiling_divide ((size_t) numChannels, (size_t) laneCount);
+    }
+
+    /** Sets the attack and release times in milliseconds */
+    void setParameters (float attackTimeMs, float releaseTimeMs)
+    {
+        tauAttack = calcTimeConstant (attackTimeMs);
+        tauRelease = calcTimeConstant (releaseTimeMs);
+    }
+
+    /**
+     * Slews a group of interleaved gain signals in place. The output is the
+     * lesser of the input gain and the slewed gain, so gain reduction is
+     * never slower than the gain computer asks for.
+     */
+    void process (float* interleavedGain, int numSamples, size_t group) noexcept
+    {
+        const auto att = Vec (tauAttack);
+        const auto rel = Vec (tauRelease);
+
+        auto z = state[group];
+        for (int n = 0; n < numSamples; ++n)
+        {
+            auto* data = interleavedGain + n * laneCount;
+            const auto g = xsimd::load_aligned (data);
+
+            z += xsimd::select (g > z, att, rel) * (g - z);
+            xsimd::store_aligned (data, xsimd::min (g, z));
+        }
+
+        state[group] = z;
+    }
+
+    /** Returns true if the slewed gain has settled at (very nearly) unity gain for every channel */
+    bool isSettledAtUnity() const noexcept
+    {
+        constexpr auto threshold = 1.0f - 1.0e-4f;
+        for (int ch = 0; ch < numActiveChannels; ++ch)
+            if (state[size_t (ch / laneCount)].get (size_t (ch % laneCount)) < threshold)
+                return false;
+
+        return true;
+    }
+
+private:
+    float calcTimeConstant (float timeMs) const noexcept
+    {
+        return timeMs < 1.0e-3f ? 0.0f : 1.0f - std::exp (expFactor / timeMs);
+    }
+
+    float expFactor = -1.0f;
+    float tauAttack = 0.0f;
+    float tauRelease = 0.0f;
+    int numActiveChannels = 0;
+
+    std::vector<Vec, xsimd::aligned_allocator<Vec>> state;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (GainSlewLimiter)
+};
+
+#endif // GAINSLEWLIMITER_H_INCLUDED
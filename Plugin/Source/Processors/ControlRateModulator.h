@@ -0,0 +1,128 @@
+#ifndef CONTROLRATEMODULATOR_H_INCLUDED
+#define CONTROLRATEMODULATOR_H_INCLUDED
+
+#include <JuceHeader.h>
+
+/**
+ * Utility class for sub-audio modulation signals (wow, flutter, drift, etc.)
+ * The modulation is generated at a decimated "control" rate, and then
+ * linearly interpolated back up to the audio rate.
+ *
+ * Each channel can generate several signals at once, all sharing the
+ * same control-rate clock.
+ */
+template <size_t numSignals = 1>
+class ControlRateModulator
+{
+public:
+    using Frame = std::array<float, numSignals>;
+
+    static constexpr int decimationFactor = 16;
+
+    ControlRateModulator() = default;
+
+    void prepare (double sampleRate, int samplesPerBlock, int numChannels)
+    {
+        controlRate = sampleRate / (double) decimationFactor;
+
+        for (auto& buffer : buffers)
+            buffer.setSize (numChannels, samplesPerBlock);
+
+        value.resize ((size_t) numChannels);
+        target.resize ((size_t) numChannels);
+        increment.resize ((size_t) numChannels);
+
+        reset();
+    }
+
+    void reset()
+    {
+        for (auto* state : { &value, &target, &increment })
+            std::fill (state->begin(), state->end(), Frame {});
+
+        samplesUntilUpdate = 0;
+    }
+
+    /** Returns the rate (Hz) at which the generator function will be called */
+    double getControlRate() const noexcept { return controlRate; }
+
+    /** Returns the largest number of control frames that can be generated for a block of this size */
+    static int getMaxNumControlFrames (int numSamples) noexcept { return numSamples / decimationFactor + 1; }
+
+    /**
+     * Renders a block of modulation at the audio rate.
+     *
+     * The generator will be called as generator (channel, frameIndex),
+     * and should return the next control-rate Frame for that channel.
+     */
+    template <typename Generator>
+    void process (int numSamples, int numChannels, Generator&& generator)
+    {
+        // the buffers are allocated in prepare(), so the audio thread never needs to resize them
+        jassert (numChannels <= buffers[0].getNumChannels() && numSamples <= buffers[0].getNumSamples());
+        renderedChannels = numChannels;
+        renderedSamples = numSamples;
+
+        int counter = samplesUntilUpdate;
+        for (size_t ch = 0; ch < (size_t) numChannels; ++ch)
+        {
+            counter = samplesUntilUpdate;
+            int frameIdx = 0;
+            for (int n = 0; n < numSamples;)
+            {
+                if (counter == 0)
+                {
+                    const auto nextFrame = generator (ch, frameIdx++);
+                    for (size_t i = 0; i < numSignals; ++i)
+                    {
+                        value[ch][i] = target[ch][i];
+                        target[ch][i] = nextFrame[i];
+                        increment[ch][i] = (target[ch][i] - value[ch][i]) / (float) decimationFactor;
+                    }
+
+                    counter = decimationFactor;
+                }
+
+                const auto samplesToProcess = jmin (counter, numSamples - n);
+                for (size_t i = 0; i < numSignals; ++i)
+                {
+                    auto* x = buffers[i].getWritePointer ((int) ch, n);
+                    const auto start = value[ch][i];
+                    const auto inc = increment[ch][i];
+                    for (int k = 0; k < samplesToProcess; ++k)
+                        x[k] = start + inc * (float) k;
+
+                    value[ch][i] = start + inc * (float) samplesToProcess;
+                }
+
+                counter -= samplesToProcess;
+                n += samplesToProcess;
+            }
+        }
+
+        samplesUntilUpdate = counter;
+    }
+
+    /** Returns the (full-size) audio-rate buffer for one of the modulation signals */
+    AudioBuffer<float>& getBuffer (size_t signal = 0) noexcept { return buffers[signal]; }
+
+    /** Returns a view of the most recently rendered block for one of the modulation signals */
+    AudioBuffer<float> getRenderedBlock (size_t signal = 0) noexcept
+    {
+        return { buffers[signal].getArrayOfWritePointers(), renderedChannels, renderedSamples };
+    }
+    const float* getReadPointer (size_t signal, size_t ch) const noexcept { return buffers[signal].getReadPointer ((int) ch); }
+
+private:
+    double controlRate = 48000.0 / (double) decimationFactor;
+    int samplesUntilUpdate = 0;
+    int renderedChannels = 0;
+    int renderedSamples = 0;
+
+    std::vector<Frame> value, target, increment;
+    std::array<AudioBuffer<float>, numSignals> buffers;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ControlRateModulator)
+};
+
+#endif // CONTROLRATEMODULATOR_H_INCLUDED
@@ -37,14 +37,48 @@ public:
     inline void process (float* buffer, int numSamples)
     {
         for (int n = 0; n < numSamples; ++n)
+            buffer[n] = processSampleSmoothed (buffer[n]);
+    }
+
+    /**
+     * Processes a block of samples. While the cutoff is smoothing, the
+     * coefficients are only updated once every coefUpdateInterval samples.
+     */
+    inline void processSubRate (float* buffer, int numSamples)
+    {
+        if (! freq.isSmoothing())
         {
-            if (freq.isSmoothing())
-                calcCoefs (freq.getNextValue());
+            for (int n = 0; n < numSamples; ++n)
+                buffer[n] = processSample (buffer[n]);
+            return;
+        }
 
-            buffer[n] = processSample (buffer[n]);
+        for (int n = 0; n < numSamples; n += coefUpdateInterval)
+        {
+            const auto subBlockSize = jmin (coefUpdateInterval, numSamples - n);
+            updateSmoothing (subBlockSize);
+
+            for (int k = n; k < n + subBlockSize; ++k)
+                buffer[k] = processSample (buffer[k]);
         }
     }
 
+    /** If the cutoff is still smoothing, skips it ahead by numSamples, and updates the coefficients once */
+    inline void updateSmoothing (int numSamples)
+    {
+        if (freq.isSmoothing())
+            calcCoefs (freq.skip (numSamples));
+    }
+
+    /** Processes a single sample, updating the filter coefficients if the cutoff is still smoothing */
+    inline float processSampleSmoothed (float x)
+    {
+        if (freq.isSmoothing())
+            calcCoefs (freq.getNextValue());
+
+        return processSample (x);
+    }
+
     inline float processSample (float x)
     {
         float y = z[1] + x * b[0];
@@ -54,9 +88,12 @@ public:
 
     void setFreq (float newFreq)
     {
-        freq.setTargetValue (newFreq);
+        if (newFreq != freq.getTargetValue())
+            freq.setTargetValue (newFreq);
     }
 
+    static constexpr int coefUpdateInterval = 16;
+
 private:
     SmoothedValue<float, ValueSmoothingTypes::Multiplicative> freq = 20000.0f;
     float fs = 44100.0f;
@@ -3,11 +3,18 @@
 
 #include "JuceHeader.h"
 
-/** Noise for tape degrade effect */
+/**
+ * Noise for tape degrade effect.
+ *
+ * Uniform noise is generated by a bank of xoshiro128+ generators,
+ * stored lane-by-lane so the compiler can step all of them as one
+ * SIMD vector. The noise stream is fully determined by the seed, and
+ * does not depend on the block sizes used to process it.
+ */
 class DegradeNoise
 {
 public:
-    DegradeNoise() = default;
+    DegradeNoise() { setSeed (0); }
     DegradeNoise (DegradeNoise&&) noexcept = default;
 
     void setGain (float newGain) { curGain = newGain; }
@@ -17,27 +24,100 @@ public:
         prevGain = curGain;
     }
 
+    /** Resets the noise generator state using a new seed */
+    void setSeed (uint64 seed) noexcept
+    {
+        // seed the generator lanes with splitmix64, as recommended by the xoshiro authors
+        auto splitMix = [&seed]() -> uint64 {
+            auto z = (seed += 0x9e3779b97f4a7c15);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+            return z ^ (z >> 31);
+        };
+
+        for (int i = 0; i < numLanes; ++i)
+        {
+            const auto a = splitMix();
+            const auto b = splitMix();
+            s0[i] = (uint32) a;
+            s1[i] = (uint32) (a >> 32);
+            s2[i] = (uint32) b;
+            s3[i] = (uint32) (b >> 32) | 1; // state must not be all zeros
+        }
+
+        cachePos = numLanes;
+    }
+
     void processBlock (float* buffer, int numSamples)
     {
         if (curGain == prevGain)
         {
-            for (int n = 0; n < numSamples; ++n)
-                buffer[n] += (random.nextFloat() - 0.5f) * curGain;
+            processBlock (buffer, numSamples, curGain, 0.0f);
         }
         else
         {
-            for (int n = 0; n < numSamples; ++n)
-                buffer[n] += (random.nextFloat() - 0.5f) * ((curGain * (float) n / (float) numSamples) + (prevGain * (1.0f - (float) n / (float) numSamples)));
-
+            processBlock (buffer, numSamples, prevGain, (curGain - prevGain) / (float) numSamples);
             prevGain = curGain;
         }
     }
 
+    /** Adds noise to the buffer, with the gain ramping from startGain by gainInc every sample */
+    void processBlock (float* buffer, int numSamples, float startGain, float gainInc) noexcept
+    {
+        int n = 0;
+
+        // use up noise left over from the previous block
+        for (; cachePos < numLanes && n < numSamples; ++cachePos, ++n)
+            buffer[n] += cache[cachePos] * (startGain + gainInc * (float) n);
+
+        for (; n + numLanes <= numSamples; n += numLanes)
+        {
+            nextUniform (cache);
+            for (int k = 0; k < numLanes; ++k)
+                buffer[n + k] += cache[k] * (startGain + gainInc * (float) (n + k));
+        }
+
+        if (n < numSamples)
+        {
+            nextUniform (cache);
+            for (cachePos = 0; n < numSamples; ++cachePos, ++n)
+                buffer[n] += cache[cachePos] * (startGain + gainInc * (float) n);
+        }
+    }
+
 private:
+    static constexpr int numLanes = 8;
+
+    /** Steps each generator lane, and fills dest with uniform noise in [-0.5, 0.5) */
+    inline void nextUniform (float* dest) noexcept
+    {
+        for (int i = 0; i < numLanes; ++i)
+        {
+            const auto result = s0[i] + s3[i];
+            const auto t = s1[i] << 9;
+
+            s2[i] ^= s0[i];
+            s3[i] ^= s1[i];
+            s1[i] ^= s2[i];
+            s0[i] ^= s3[i];
+            s2[i] ^= t;
+            s3[i] = (s3[i] << 11) | (s3[i] >> 21);
+
+            // top 24 bits -> [0, 1)
+            dest[i] = (float) (int32) (result >> 8) * (1.0f / 16777216.0f) - 0.5f;
+        }
+    }
+
     float curGain = 0.0f;
     float prevGain = curGain;
 
-    Random random;
+    alignas (32) uint32 s0[numLanes];
+    alignas (32) uint32 s1[numLanes];
+    alignas (32) uint32 s2[numLanes];
+    alignas (32) uint32 s3[numLanes];
+
+    alignas (32) float cache[numLanes] {};
+    int cachePos = numLanes;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DegradeNoise)
 };
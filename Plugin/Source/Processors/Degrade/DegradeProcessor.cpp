@@ -1,6 +1,6 @@
 #include "DegradeProcessor.h"
 
-DegradeProcessor::DegradeProcessor (AudioProcessorValueTreeState& vts)
+DegradeProcessor::DegradeProcessor (AudioProcessorValueTreeState& vts, BypassManager& bypassManager) : bypass (bypassManager)
 {
     using namespace chowdsp::ParamUtils;
     point1xParam = vts.getRawParameterValue ("deg_point1x");
@@ -30,56 +30,62 @@ void DegradeProcessor::cookParams()
     float freqHz = 200.0f * powf (20000.0f / 200.0f, 1.0f - *amtParam);
     float gainDB = -24.0f * depthValue;
 
-    for (auto& noise : noiseProc)
-        noise.setGain (0.5f * depthValue * *amtParam);
+    noiseGain.setTarget (0.5f * depthValue * *amtParam);
 
-    for (auto& filter : filterProc)
-        filter.setFreq (jmin (freqHz + (*varParam * (freqHz / 0.6f) * (random.nextFloat() - 0.5f)), 0.49f * fs));
+    if (varianceCounter == 0)
+    {
+        for (auto& variance : freqVariance)
+            variance = random.nextFloat() - 0.5f;
+        gainVariance = random.nextFloat() - 0.5f;
+    }
+
+    // (the filter only starts smoothing again if the cutoff has actually changed)
+    for (size_t ch = 0; ch < filterProc.size(); ++ch)
+        filterProc[ch].setFreq (jmin (freqHz + (*varParam * (freqHz / 0.6f) * freqVariance[ch]), 0.49f * fs));
 
     auto envSkew = 1.0f - std::pow (envParam->getCurrentValue(), 0.8f);
     levelDetector.setParameters (10.0f, 20.0f * std::pow (5000.0f / 20.0f, envSkew));
-    gainProc.setGain (Decibels::decibelsToGain (jmin (gainDB + (*varParam * 36.0f * (random.nextFloat() - 0.5f)), 3.0f)));
+    outGain.setTarget (Decibels::decibelsToGain (jmin (gainDB + (*varParam * 36.0f * gainVariance), 3.0f)));
+}
+
+void DegradeProcessor::setCookStride (int newStride)
+{
+    jassert (newStride > 0 && varianceInterval % newStride == 0);
+    cookStride = newStride;
+    sampleCounter = 0;
 }
 
 void DegradeProcessor::prepareToPlay (double sampleRate, int samplesPerBlock, int numChannels)
 {
     fs = (float) sampleRate;
+    const auto curSeed = seed.load();
+    random.setSeed ((int64) curSeed);
+
+    filterProc.resize ((size_t) numChannels);
+    freqVariance.assign ((size_t) numChannels, 0.0f);
+    gainVariance = 0.0f;
+    varianceCounter = 0;
     cookParams();
+    noiseGain.reset();
+    outGain.reset();
 
     noiseProc.resize ((size_t) numChannels);
-    for (auto& noise : noiseProc)
-        noise.prepare();
+    for (size_t ch = 0; ch < (size_t) numChannels; ++ch)
+        noiseProc[ch].setSeed (curSeed + ch);
 
-    filterProc.resize ((size_t) numChannels);
     for (auto& filter : filterProc)
         filter.reset ((float) sampleRate, 20);
 
-    noiseBuffer.setSize (numChannels, samplesPerBlock);
     levelBuffer.setSize (1, samplesPerBlock);
 
     levelDetector.prepare ({ sampleRate, (uint32) samplesPerBlock, (uint32) numChannels });
-    gainProc.prepareToPlay (sampleRate, samplesPerBlock);
-    bypass.prepare (samplesPerBlock, numChannels, bypass.toBool (onOffParam));
+    wasApplyingEnvelope = false;
+    bypass.prepare (bypass.toBool (onOffParam));
 
     sampleCounter = 0;
 }
 
 void DegradeProcessor::processBlock (AudioBuffer<float>& buffer)
-{
-    const auto numChannels = buffer.getNumChannels();
-    const auto numSamples = buffer.getNumSamples();
-    for (int i = 0; i < numSamples;)
-    {
-        int samplesToProcess = jmin (smallBlockSize, numSamples - i);
-
-        auto&& smallBuffer = AudioBuffer<float> { buffer.getArrayOfWritePointers(), numChannels, i, samplesToProcess };
-        processShortBlock (smallBuffer);
-
-        i += samplesToProcess;
-    }
-}
-
-void DegradeProcessor::processShortBlock (AudioBuffer<float>& buffer)
 {
     if (! bypass.processBlockIn (buffer, bypass.toBool (onOffParam)))
         return;
@@ -87,37 +93,93 @@ void DegradeProcessor::processShortBlock (AudioBuffer<float>& buffer)
     const auto numChannels = buffer.getNumChannels();
     const auto numSamples = buffer.getNumSamples();
 
-    sampleCounter += numSamples;
-    if (sampleCounter >= smallBlockSize)
+    // the level detector only runs while the envelope is in use, so it is
+    // reset when the envelope comes back on, rather than starting from a stale level
+    const auto applyEnvelope = envParam->getCurrentValue() > 0.0f;
+    if (applyEnvelope && ! wasApplyingEnvelope)
+        levelDetector.reset();
+    wasApplyingEnvelope = applyEnvelope;
+
+    if (applyEnvelope)
     {
-        cookParams();
-        sampleCounter = 0;
+        dsp::AudioBlock<float> block (buffer);
+        dsp::AudioBlock<float> levelBlock (levelBuffer.getArrayOfWritePointers(), 1, (size_t) numSamples);
+        levelDetector.process (dsp::ProcessContextNonReplacing<float> { block, levelBlock });
     }
 
-    noiseBuffer.setSize (numChannels, numSamples, false, false, true);
-    noiseBuffer.clear();
+    // parameters are re-cooked every cookStride samples (independent
+    // of the host block size), and gain changes are ramped over the stride
+    for (int i = 0; i < numSamples;)
+    {
+        if (sampleCounter == 0)
+        {
+            noiseGain.prev = noiseGain.cur;
+            outGain.prev = outGain.cur;
+            cookParams();
+        }
+
+        const auto samplesToProcess = jmin (cookStride - sampleCounter, numSamples - i);
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            auto* x = buffer.getWritePointer (ch, i);
+            const auto* level = applyEnvelope ? levelBuffer.getReadPointer (0, i) : nullptr;
+
+            if (applyEnvelope)
+                processChannel<true> ((size_t) ch, x, level, samplesToProcess);
+            else
+                processChannel<false> ((size_t) ch, x, level, samplesToProcess);
+        }
+
+        sampleCounter += samplesToProcess;
+        if (sampleCounter == cookStride)
+        {
+            sampleCounter = 0;
+            varianceCounter = (varianceCounter + cookStride) % varianceInterval;
+        }
 
-    dsp::AudioBlock<float> block (buffer);
-    dsp::AudioBlock<float> levelBlock (levelBuffer.getArrayOfWritePointers(), 1, numSamples);
-    dsp::ProcessContextNonReplacing<float> levelContext (block, levelBlock);
-    levelDetector.process (levelContext);
-    const auto* levelPtr = levelBuffer.getReadPointer (0);
+        i += samplesToProcess;
+    }
 
-    const auto applyEnvelope = envParam->getCurrentValue() > 0.0f;
-    for (int ch = 0; ch < numChannels; ++ch)
-    {
-        auto* noisePtr = noiseBuffer.getWritePointer (ch);
-        noiseProc[(size_t) ch].processBlock (noisePtr, numSamples);
+    bypass.processBlockOut (buffer, bypass.toBool (onOffParam));
+}
 
-        if (applyEnvelope)
-            FloatVectorOperations::multiply (noisePtr, levelPtr, numSamples);
+template <bool applyEnvelope>
+void DegradeProcessor::processChannel (size_t ch, float* x, const float* level, int numSamples) noexcept
+{
+    auto& noise = noiseProc[ch];
+    auto& filter = filterProc[ch];
 
-        auto* xPtr = buffer.getWritePointer (ch);
-        FloatVectorOperations::add (xPtr, noisePtr, numSamples);
+    const auto rampScale = 1.0f / (float) cookStride;
+    const auto noiseGainInc = (noiseGain.cur - noiseGain.prev) * rampScale;
+    const auto outGainInc = (outGain.cur - outGain.prev) * rampScale;
+    const auto rampStart = (float) sampleCounter;
 
-        filterProc[(size_t) ch].process (xPtr, numSamples);
+    float noiseData[kernelBlockSize];
+    for (int n = 0; n < numSamples; n += kernelBlockSize)
+    {
+        const auto kernelSamples = jmin (kernelBlockSize, numSamples - n);
+        const auto rampPos = rampStart + (float) n;
+
+        std::fill (noiseData, noiseData + kernelSamples, 0.0f);
+        noise.processBlock (noiseData, kernelSamples, noiseGain.prev + noiseGainInc * rampPos, noiseGainInc);
+
+        auto* xData = x + n;
+        const auto outGainStart = outGain.prev + outGainInc * rampPos;
+        for (int k = 0; k < kernelSamples;)
+        {
+            // while the cutoff is smoothing, the filter coefficients are only updated once per sub-block
+            const auto subBlockEnd = jmin (k + DegradeFilter::coefUpdateInterval, kernelSamples);
+            filter.updateSmoothing (subBlockEnd - k);
+
+            for (; k < subBlockEnd; ++k)
+            {
+                auto noiseSample = noiseData[k];
+                if constexpr (applyEnvelope)
+                    noiseSample *= level[n + k];
+
+                const auto y = filter.processSample (xData[k] + noiseSample);
+                xData[k] = y * (outGainStart + outGainInc * (float) k);
+            }
+        }
     }
-
-    gainProc.processBlock (buffer);
-    bypass.processBlockOut (buffer, bypass.toBool (onOffParam));
 }
@@ -2,23 +2,34 @@
 #define DEGRADEPROCESSOR_H_INCLUDED
 
 #include "../BypassProcessor.h"
-#include "../GainProcessor.h"
 #include "DegradeFilter.h"
 #include "DegradeNoise.h"
 
 class DegradeProcessor
 {
 public:
-    DegradeProcessor (AudioProcessorValueTreeState& vts);
+    DegradeProcessor (AudioProcessorValueTreeState& vts, BypassManager& bypassManager);
 
     static void createParameterLayout (chowdsp::Parameters& params);
 
     void cookParams();
+
+    /** Sets how often (in samples) the parameters are re-cooked */
+    void setCookStride (int newStride);
+
     void prepareToPlay (double sampleRate, int samplesPerBlock, int numChannels);
     void processBlock (AudioBuffer<float>& buffer);
 
+    /**
+     * Sets the seed used for the noise and parameter variance, so that renders are reproducible.
+     * The new seed takes effect the next time prepareToPlay() is called.
+     */
+    void setSeed (uint64 newSeed) noexcept { seed = newSeed; }
+
 private:
-    void processShortBlock (AudioBuffer<float>& buffer);
+    /** Fused per-channel kernel: noise, envelope, filter, and output gain in a single pass */
+    template <bool applyEnvelope>
+    void processChannel (size_t ch, float* x, const float* level, int numSamples) noexcept;
 
     std::atomic<float>* point1xParam = nullptr;
     std::atomic<float>* onOffParam = nullptr;
@@ -28,22 +39,45 @@ private:
     chowdsp::FloatParameter* envParam = nullptr;
 
     std::vector<DegradeFilter> filterProc;
-    GainProcessor gainProc;
-
-    AudioBuffer<float> noiseBuffer;
     std::vector<DegradeNoise> noiseProc;
 
+    /**
+     * Random values for the parameter variance. A new random value is chosen every
+     * varianceInterval samples (and held in between), so the variance doesn't depend
+     * on how often the parameters are cooked.
+     */
+    std::vector<float> freqVariance; // one per channel
+    float gainVariance = 0.0f;
+
+    /** Gain value that ramps linearly between parameter cooks */
+    struct CookedGain
+    {
+        float prev = 0.0f;
+        float cur = 0.0f;
+
+        void setTarget (float newGain) { cur = newGain; }
+        void reset() { prev = cur; }
+    };
+
+    CookedGain noiseGain;
+    CookedGain outGain;
+
     AudioBuffer<float> levelBuffer;
     chowdsp::LevelDetector<float> levelDetector;
+    bool wasApplyingEnvelope = false;
 
     Random random;
+    std::atomic<uint64> seed { (uint64) Random::getSystemRandom().nextInt64() }; // different for each instance, so tracks stay decorrelated
 
     float fs = 44100.0f;
 
     BypassProcessor bypass;
 
-    static constexpr int smallBlockSize = 2048;
-    int sampleCounter = 0;
+    static constexpr int varianceInterval = 2048;
+    static constexpr int kernelBlockSize = 64;
+    int cookStride = 32;
+    int sampleCounter = 0; // position within the current cook stride
+    int varianceCounter = 0; // position within the current variance interval
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DegradeProcessor)
 };
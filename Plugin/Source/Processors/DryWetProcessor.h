@@ -3,7 +3,14 @@
 
 #include "JuceHeader.h"
 
-/** Simple processor to mix dry and wet signals */
+/**
+ * Simple processor to mix dry and wet signals.
+ *
+ * The dry signal goes through a latency compensation delay line, which is
+ * fed at the start of the block (pushDry), and read back while mixing with
+ * the wet signal at the end (processBlock). When the mix is fully wet, the
+ * dry path is skipped entirely.
+ */
 class DryWetProcessor
 {
 public:
@@ -12,35 +19,117 @@ public:
     void setDryWet (float newDryWet) { dryWet = newDryWet; }
     float getDryWet() const noexcept { return dryWet; }
 
-    void reset() { lastDryWet = dryWet; }
+    void reset()
+    {
+        lastDryWet = dryWet;
+        dryActive = false;
+    }
+
+    /** Returns true if the dry signal is not needed for this block */
+    bool isFullyWet() const noexcept { return dryWet == 1.0f && lastDryWet == 1.0f; }
+
+    /** Pushes the dry signal into the latency compensation delay line, unless the mix is fully wet */
+    template <typename DelayType>
+    void pushDry (DelayType& dryDelay, const AudioBuffer<float>& dryBuffer, bool forceActive = false)
+    {
+        if (isFullyWet() && ! forceActive)
+        {
+            dryActive = false;
+            return;
+        }
+
+        if (! dryActive)
+        {
+            // The delay line history is out of date, so we'll need to re-fill it before using the dry signal.
+            // Until then, the stale history is cleared, so that anything reading it (e.g. the bypassed
+            // processing) gets silence rather than a burst of old audio.
+            dryActive = true;
+            samplesPushed = 0;
+            dryDelay.clearHistory ((int) std::ceil (dryDelay.getDelay()) + interpMargin);
+        }
+
+        const auto numSamples = dryBuffer.getNumSamples();
+        for (int ch = 0; ch < dryBuffer.getNumChannels(); ++ch)
+        {
+            const auto* x = dryBuffer.getReadPointer (ch);
+            for (int n = 0; n < numSamples; ++n)
+                dryDelay.pushSample (ch, x[n]);
+        }
+
+        pushedThisBlock = numSamples;
+    }
+
+    /** Replaces the buffer with the delayed dry signal */
+    template <typename DelayType>
+    void popDry (DelayType& dryDelay, AudioBuffer<float>& buffer)
+    {
+        const auto numSamples = buffer.getNumSamples();
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+        {
+            auto* x = buffer.getWritePointer (ch);
+            for (int n = 0; n < numSamples; ++n)
+                x[n] = dryDelay.popSample (ch);
+        }
+
+        finishBlock();
+    }
 
     /**
-      Mix dry and wet buffer. Mixed buffer returned in place of wet buffer
+      Mix the delayed dry signal with the wet buffer, in place. The output gain
+      (ramping from outGainStart to outGainEnd) is applied to the wet signal only.
     */
-    void processBlock (AudioBuffer<float>& dryBuffer, AudioBuffer<float>& wetBuffer)
+    template <typename DelayType>
+    void processBlock (DelayType& dryDelay, AudioBuffer<float>& wetBuffer, float outGainStart, float outGainEnd)
     {
-        if (lastDryWet == dryWet)
+        const auto numChannels = wetBuffer.getNumChannels();
+        const auto numSamples = wetBuffer.getNumSamples();
+        const auto outGainInc = (outGainEnd - outGainStart) / (float) numSamples;
+
+        if (! dryActive)
         {
-            wetBuffer.applyGain (dryWet);
-            for (int ch = 0; ch < wetBuffer.getNumChannels(); ++ch)
-                wetBuffer.addFrom (ch, 0, dryBuffer.getReadPointer (ch), wetBuffer.getNumSamples(), (1.0f - dryWet));
+            wetBuffer.applyGainRamp (0, numSamples, outGainStart, outGainEnd);
+            return;
         }
-        else
+
+        // hold the mix until all the delayed samples we read were pushed since the dry path became active
+        const auto dryIsValid = samplesPushed >= (int) std::ceil (dryDelay.getDelay()) + interpMargin;
+        const auto startDryWet = dryIsValid ? lastDryWet : 1.0f;
+        const auto endDryWet = dryIsValid ? dryWet : 1.0f;
+        const auto dryWetInc = (endDryWet - startDryWet) / (float) numSamples;
+
+        for (int ch = 0; ch < numChannels; ++ch)
         {
-            for (int ch = 0; ch < wetBuffer.getNumChannels(); ++ch)
+            auto* x = wetBuffer.getWritePointer (ch);
+            for (int n = 0; n < numSamples; ++n)
             {
-                wetBuffer.applyGainRamp (ch, 0, wetBuffer.getNumSamples(), lastDryWet, dryWet);
-                wetBuffer.addFromWithRamp (ch, 0, dryBuffer.getReadPointer (ch), wetBuffer.getNumSamples(), (1.0f - lastDryWet), (1.0f - dryWet));
+                const auto mix = startDryWet + dryWetInc * (float) n;
+                const auto wetGain = (outGainStart + outGainInc * (float) n) * mix;
+                x[n] = x[n] * wetGain + dryDelay.popSample (ch) * (1.0f - mix);
             }
+        }
 
+        if (dryIsValid)
             lastDryWet = dryWet;
-        }
+
+        finishBlock();
     }
 
 private:
+    void finishBlock() noexcept
+    {
+        samplesPushed = jmin (samplesPushed + pushedThisBlock, std::numeric_limits<int>::max() / 2);
+        pushedThisBlock = 0;
+    }
+
+    static constexpr int interpMargin = 4; // extra samples read by the delay line interpolation
+
     float dryWet = 0.0f;
     float lastDryWet = 0.0f;
 
+    bool dryActive = false;
+    int samplesPushed = 0;
+    int pushedThisBlock = 0;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DryWetProcessor)
 };
 
@@ -36,6 +36,12 @@ public:
 
     float getGain() const { return curGain; }
 
+    /** Returns the start and end gains for the next block, for when the gain is applied elsewhere */
+    std::pair<float, float> getNextBlockGains() noexcept
+    {
+        return { std::exchange (oldGain, curGain), curGain };
+    }
+
 private:
     float curGain = 1.0f;
     float oldGain = 0.0f;
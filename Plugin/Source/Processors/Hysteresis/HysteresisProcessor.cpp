@@ -42,7 +42,8 @@ static void deinterleaveSamples (const T* source, T** dest, int numSamples, int
 }
 } // namespace
 
-HysteresisProcessor::HysteresisProcessor (AudioProcessorValueTreeState& vts) : osManager (vts)
+HysteresisProcessor::HysteresisProcessor (AudioProcessorValueTreeState& vts, BypassManager& bypassManager) : osManager (vts),
+                                                                                                     bypass (bypassManager)
 {
     using namespace chowdsp::ParamUtils;
     loadParameterPointer (driveParam, vts, "drive");
@@ -50,6 +51,7 @@ HysteresisProcessor::HysteresisProcessor (AudioProcessorValueTreeState& vts) : o
     loadParameterPointer (widthParam, vts, "width");
     modeParam = vts.getRawParameterValue ("mode");
     onOffParam = vts.getRawParameterValue ("hyst_onoff");
+    sharedOSParam = vts.getRawParameterValue ("os_shared");
 }
 
 void HysteresisProcessor::createParameterLayout (chowdsp::Parameters& params)
@@ -64,6 +66,7 @@ void HysteresisProcessor::createParameterLayout (chowdsp::Parameters& params)
 
     using OSManager = decltype (osManager);
     OSManager::createParameterLayout (params, OSManager::OSFactor::TwoX, OSManager::OSMode::MinPhase);
+    emplace_param<chowdsp::BoolParameter> (params, "os_shared", "Shared Oversampling", false);
 }
 
 void HysteresisProcessor::setSolver (int newSolver)
@@ -117,6 +120,7 @@ void HysteresisProcessor::setOversampling()
 {
     if (osManager.updateOSFactor())
     {
+        osRevision++;
         for (size_t ch = 0; ch < hProcs.size(); ++ch)
         {
             hProcs[ch].setSampleRate (fs * osManager.getOSFactor());
@@ -169,7 +173,7 @@ void HysteresisProcessor::prepareToPlay (double sampleRate, int samplesPerBlock,
         filt.prepare (sampleRate, dcFreq);
 
     doubleBuffer.setSize (numChannels, samplesPerBlock);
-    bypass.prepare (samplesPerBlock, numChannels, bypass.toBool (onOffParam));
+    bypass.prepare (bypass.toBool (onOffParam));
 
 #if HYSTERESIS_USE_SIMD
     const auto maxOSBlockSize = (uint32) samplesPerBlock * 16;
@@ -179,12 +183,39 @@ void HysteresisProcessor::prepareToPlay (double sampleRate, int samplesPerBlock,
     zeroBlock.clear();
 
     channelPointers.resize (numVecChannels * Vec2::size);
+    const auto numChannelGroups = (int) numVecChannels; // one group for each SIMD lane pair
+#else
+    const auto numChannelGroups = numChannels;
 #endif
+
+    // worker threads for processing the channel groups in parallel (only for wide layouts)
+    numChannelWorkers = numChannels > 2 ? jmax (jmin (numChannelGroups, SystemStats::getNumPhysicalCpus()) - 1, 0) : 0;
+    channelWorkers.setParkTime ((double) samplesPerBlock / sampleRate);
+    updateChannelWorkers();
 }
 
 void HysteresisProcessor::releaseResources()
 {
     osManager.reset();
+    numChannelWorkers = 0;
+    channelWorkers.stop();
+}
+
+void HysteresisProcessor::setParallelChannelProcessing (bool shouldBeParallel)
+{
+    if (shouldBeParallel == parallelChannels.load())
+        return;
+
+    parallelChannels.store (shouldBeParallel);
+    updateChannelWorkers();
+}
+
+void HysteresisProcessor::updateChannelWorkers()
+{
+    // the worker threads are only running while they might be needed
+    const auto numWorkers = parallelChannels.load() ? numChannelWorkers : 0;
+    if (numWorkers != channelWorkers.getNumWorkers())
+        channelWorkers.start (numWorkers);
 }
 
 float HysteresisProcessor::getLatencySamples() const noexcept
@@ -194,7 +225,13 @@ float HysteresisProcessor::getLatencySamples() const noexcept
                                       : 0.0f; // off
 }
 
-void HysteresisProcessor::processBlock (AudioBuffer<float>& buffer)
+bool HysteresisProcessor::isOversamplingShared() const noexcept
+{
+    // there's no oversampling to share if the hysteresis is turned off
+    return sharedOSParam->load() == 1.0f && onOffParam->load() == 1.0f;
+}
+
+void HysteresisProcessor::processBlock (AudioBuffer<float>& buffer, const OversampledStage& preStage)
 {
     const auto numChannels = buffer.getNumChannels();
 
@@ -219,14 +256,17 @@ void HysteresisProcessor::processBlock (AudioBuffer<float>& buffer)
     wasV1 = useV1;
 
     // clip input to avoid unstable hysteresis
-    for (int ch = 0; ch < numChannels; ++ch)
+    if (preStage == nullptr)
     {
-        auto* bufferPtr = buffer.getWritePointer (ch);
-        FloatVectorOperations::clip (bufferPtr,
-                                     bufferPtr,
-                                     -clipLevel,
-                                     clipLevel,
-                                     buffer.getNumSamples());
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            auto* bufferPtr = buffer.getWritePointer (ch);
+            FloatVectorOperations::clip (bufferPtr,
+                                         bufferPtr,
+                                         -clipLevel,
+                                         clipLevel,
+                                         buffer.getNumSamples());
+        }
     }
 
     doubleBuffer.makeCopyOf (buffer, true);
@@ -234,6 +274,22 @@ void HysteresisProcessor::processBlock (AudioBuffer<float>& buffer)
     dsp::AudioBlock<double> block (doubleBuffer);
     dsp::AudioBlock<double> osBlock = osManager.processSamplesUp (block);
 
+    if (preStage != nullptr)
+    {
+        preStage (osBlock, (int) osManager.getOSFactor());
+
+        // the pre-stages may have boosted the signal, so we clip afterwards
+        for (size_t ch = 0; ch < osBlock.getNumChannels(); ++ch)
+        {
+            auto* osPtr = osBlock.getChannelPointer (ch);
+            FloatVectorOperations::clip (osPtr,
+                                         osPtr,
+                                         (double) -clipLevel,
+                                         (double) clipLevel,
+                                         (int) osBlock.getNumSamples());
+        }
+    }
+
 #if HYSTERESIS_USE_SIMD
     const auto n = osBlock.getNumSamples();
     auto* inout = channelPointers.data();
@@ -355,19 +411,32 @@ void applyMakeup (chowdsp::AudioBlock<T>& block, SmoothType& makeup)
 #endif
 }
 
+template <typename ChannelFunc>
+void HysteresisProcessor::forEachChannel (size_t numChannels, ChannelFunc&& channelFunc)
+{
+    if (parallelChannels.load (std::memory_order_relaxed))
+    {
+        auto task = [&channelFunc] (int channel) { channelFunc ((size_t) channel); };
+        channelWorkers.parallelFor ((int) numChannels, task);
+        return;
+    }
+
+    for (size_t channel = 0; channel < numChannels; ++channel)
+        channelFunc (channel);
+}
+
 template <SolverType solverType, typename T>
 void HysteresisProcessor::process (chowdsp::AudioBlock<T>& block)
 {
     const auto numChannels = block.getNumChannels();
     const auto numSamples = block.getNumSamples();
 
-    for (size_t channel = 0; channel < numChannels; ++channel)
-    {
+    forEachChannel (numChannels, [&] (size_t channel) {
         auto* x = block.getChannelPointer (channel);
         auto& hProc = hProcs[channel];
         for (size_t samp = 0; samp < numSamples; samp++)
             x[samp] = hProc.process<solverType> (x[samp]);
-    }
+    });
 
     applyMakeup<T> (block, makeup);
 }
@@ -378,8 +447,7 @@ void HysteresisProcessor::processSmooth (chowdsp::AudioBlock<T>& block)
     const auto numChannels = block.getNumChannels();
     const auto numSamples = block.getNumSamples();
 
-    for (size_t channel = 0; channel < numChannels; ++channel)
-    {
+    forEachChannel (numChannels, [&] (size_t channel) {
         auto* x = block.getChannelPointer (channel);
         auto& hProc = hProcs[channel];
         for (size_t samp = 0; samp < numSamples; samp++)
@@ -387,7 +455,7 @@ void HysteresisProcessor::processSmooth (chowdsp::AudioBlock<T>& block)
             hProc.cook (drive[channel].getNextValue(), width[channel].getNextValue(), sat[channel].getNextValue(), false);
             x[samp] = hProc.process<solverType> (x[samp]);
         }
-    }
+    });
 
     applyMakeup<T> (block, makeup);
 }
@@ -399,8 +467,7 @@ void HysteresisProcessor::processV1 (chowdsp::AudioBlock<T>& block)
     const auto numSamples = block.getNumSamples();
     const auto angleDelta = MathConstants<double>::twoPi * biasFreq / (fs * osManager.getOSFactor());
 
-    for (size_t channel = 0; channel < numChannels; ++channel)
-    {
+    forEachChannel (numChannels, [&] (size_t channel) {
         auto* x = block.getChannelPointer (channel);
         auto& hProc = hProcs[channel];
         auto& bAngle = biasAngle[channel];
@@ -413,7 +480,7 @@ void HysteresisProcessor::processV1 (chowdsp::AudioBlock<T>& block)
 
             x[samp] = hProc.process<RK4> ((x[samp] + bias) * 10000.0) * v1Norm;
         }
-    }
+    });
 }
 
 template <typename T>
@@ -423,8 +490,7 @@ void HysteresisProcessor::processSmoothV1 (chowdsp::AudioBlock<T>& block)
     const auto numSamples = block.getNumSamples();
     const auto angleDelta = MathConstants<double>::twoPi * biasFreq / (fs * osManager.getOSFactor());
 
-    for (size_t channel = 0; channel < numChannels; ++channel)
-    {
+    forEachChannel (numChannels, [&] (size_t channel) {
         auto* x = block.getChannelPointer (channel);
         auto& hProc = hProcs[channel];
         auto& bAngle = biasAngle[channel];
@@ -438,7 +504,7 @@ void HysteresisProcessor::processSmoothV1 (chowdsp::AudioBlock<T>& block)
 
             x[samp] = hProc.process<RK4> ((x[samp] + bias) * 10000.0) * v1Norm;
         }
-    }
+    });
 }
 
 void HysteresisProcessor::applyDCBlockers (AudioBuffer<float>& buffer)
@@ -2,6 +2,7 @@
 #define HYSTERESISPROCESSOR_H_INCLUDED
 
 #include "../BypassProcessor.h"
+#include "../RealtimeWorkerPool.h"
 #include "DCBlocker.h"
 #include "HysteresisProcessing.h"
 
@@ -9,7 +10,7 @@
 class HysteresisProcessor
 {
 public:
-    HysteresisProcessor (AudioProcessorValueTreeState& vts);
+    HysteresisProcessor (AudioProcessorValueTreeState& vts, BypassManager& bypassManager);
 
     /* Reset fade buffers, filters, and processors. Prepare oversampling */
     void prepareToPlay (double sampleRate, int samplesPerBlock, int numChannels);
@@ -17,14 +18,29 @@ public:
     /* Reset oversampling */
     void releaseResources();
 
-    /* Proceess a buffer. */
-    void processBlock (AudioBuffer<float>& buffer);
+    /* Processing stages that can run inside the hysteresis oversampling, before the hysteresis itself */
+    using OversampledStage = std::function<void (dsp::AudioBlock<double>& osBlock, int osFactor)>;
+
+    /* Proceess a buffer. If preStage is set, it will be run on the oversampled signal. */
+    void processBlock (AudioBuffer<float>& buffer, const OversampledStage& preStage = {});
+
+    /* Returns true if the preceding stages should share the hysteresis oversampling */
+    bool isOversamplingShared() const noexcept;
 
     static void createParameterLayout (chowdsp::Parameters& params);
 
     float getLatencySamples() const noexcept;
     auto& getOSManager() { return osManager; }
 
+    /* Incremented whenever the oversampling factor changes */
+    int getOversamplingRevision() const noexcept { return osRevision; }
+
+    /**
+     * For layouts with more than two channels, the channel groups can be processed in parallel on a small pool of
+     * worker threads (which are only started while this is enabled). Must not be called while processing!
+     */
+    void setParallelChannelProcessing (bool shouldBeParallel);
+
 private:
     void setSolver (int newSolver);
     void setDrive (float newDrive);
@@ -33,7 +49,10 @@ private:
     void setOversampling();
     double calcMakeup();
     void calcBiasFreq();
+    void updateChannelWorkers();
 
+    template <typename ChannelFunc>
+    void forEachChannel (size_t numChannels, ChannelFunc&& channelFunc);
     template <SolverType solverType, typename T>
     void process (chowdsp::AudioBlock<T>& block);
     template <SolverType solverType, typename T>
@@ -49,6 +68,7 @@ private:
     chowdsp::FloatParameter* widthParam = nullptr;
     std::atomic<float>* modeParam = nullptr;
     std::atomic<float>* onOffParam = nullptr;
+    std::atomic<float>* sharedOSParam = nullptr;
 
     std::vector<SmoothedValue<double, ValueSmoothingTypes::Linear>> drive;
     std::vector<SmoothedValue<double, ValueSmoothingTypes::Linear>> width;
@@ -58,6 +78,7 @@ private:
     double fs = 44100.0f;
     chowdsp::VariableOversampling<double> osManager; // needs oversampling to avoid aliasing
     std::vector<HysteresisProcessing> hProcs;
+    int osRevision = 0;
     SolverType solver = SolverType::RK4;
     std::vector<DCBlocker> dcBlocker;
 
@@ -72,6 +93,10 @@ private:
     AudioBuffer<double> doubleBuffer;
     BypassProcessor bypass;
 
+    RealtimeWorkerPool channelWorkers { "ChowTape Channel Worker" };
+    std::atomic<bool> parallelChannels { false };
+    int numChannelWorkers = 0; // for the current layout, when processing in parallel
+
 #if HYSTERESIS_USE_SIMD
     using Vec2 = xsimd::batch<double>;
     chowdsp::AudioBlock<Vec2> interleavedBlock;
@@ -0,0 +1,122 @@
+#ifndef MULTICHANNELSHELFFILTER_H_INCLUDED
+#define MULTICHANNELSHELFFILTER_H_INCLUDED
+
+#include <JuceHeader.h>
+#include <xsimd/xsimd.hpp>
+
+/**
+ * First-order shelving filter, with the same response as chowdsp::ShelfFilter.
+ *
+ * All channels share one set of coefficients, and groups of channels are
+ * processed in parallel SIMD lanes. The coefficients can be ramped linearly
+ * over a block, while keeping the filter state.
+ */
+class MultiChannelShelfFilter
+{
+public:
+    using Vec = xsimd::batch<float>;
+    static constexpr auto laneCount = (int) Vec::size;
+
+    struct Coefs
+    {
+        float b0 = 1.0f;
+        float b1 = 0.0f;
+        float a1 = 0.0f;
+    };
+
+    MultiChannelShelfFilter() = default;
+
+    void prepare (int numChannels)
+    {
+        state.resize (chowdsp::Math::ceiling_divide ((size_t) numChannels, (size_t) laneCount));
+        reset();
+    }
+
+    void reset()
+    {
+        std::fill (state.begin(), state.end(), Vec (0.0f));
+    }
+
+    /** Computes the filter coefficients (bilinear transform of the analog shelf prototype) */
+    static Coefs calcCoefs (float lowGain, float highGain, float fc, float fs) noexcept
+    {
+        // reduce to simple gain element
+        if (lowGain == highGain)
+            return { lowGain, 0.0f, 0.0f };
+
+        const auto rho = std::sqrt (highGain / lowGain);
+        const auto K = 1.0f / std::tan (MathConstants<float>::pi * fc / fs);
+
+        const auto a0Inv = 1.0f / (K / rho + 1.0f);
+        return { (highGain / rho * K + lowGain) * a0Inv,
+                 (-highGain / rho * K + lowGain) * a0Inv,
+                 (-K / rho + 1.0f) * a0Inv };
+    }
+
+    /**
+     * Processes numSamples starting at startSample, with the coefficients
+     * ramping from startCoefs, to arrive at endCoefs on the last sample.
+     * The filter always runs in single precision, but the data can be double
+     * (e.g. inside the hysteresis oversampling), since it's copied into the SIMD lanes anyway.
+     */
+    template <typename SampleType>
+    void process (SampleType* const* data, int numChannels, int startSample, int numSamples, const Coefs& startCoefs, const Coefs& endCoefs) noexcept
+    {
+        const auto rampInc = 1.0f / (float) numSamples;
+        for (size_t group = 0; group < state.size(); ++group)
+        {
+            const auto startChannel = (int) group * laneCount;
+            const auto channelsInGroup = jmin (laneCount, numChannels - startChannel);
+
+            auto z = state[group];
+            for (int start = 0; start < numSamples; start += chunkSize)
+            {
+                const auto samplesToProcess = jmin (chunkSize, numSamples - start);
+
+                auto* x = reinterpret_cast<float*> (chunk);
+                for (int lane = 0; lane < channelsInGroup; ++lane)
+                {
+                    const auto* in = data[startChannel + lane] + startSample + start;
+                    for (int n = 0; n < samplesToProcess; ++n)
+                        x[n * laneCount + lane] = (float) in[n];
+                }
+
+                for (int lane = channelsInGroup; lane < laneCount; ++lane)
+                    for (int n = 0; n < samplesToProcess; ++n)
+                        x[n * laneCount + lane] = 0.0f;
+
+                for (int n = 0; n < samplesToProcess; ++n)
+                {
+                    const auto alpha = rampInc * (float) (start + n + 1);
+                    const auto b0 = startCoefs.b0 + alpha * (endCoefs.b0 - startCoefs.b0);
+                    const auto b1 = startCoefs.b1 + alpha * (endCoefs.b1 - startCoefs.b1);
+                    const auto a1 = startCoefs.a1 + alpha * (endCoefs.a1 - startCoefs.a1);
+
+                    // transposed direct form II
+                    const auto y = z + chunk[n] * b0;
+                    z = chunk[n] * b1 - y * a1;
+                    chunk[n] = y;
+                }
+
+                for (int lane = 0; lane < channelsInGroup; ++lane)
+                {
+                    auto* out = data[startChannel + lane] + startSample + start;
+                    for (int n = 0; n < samplesToProcess; ++n)
+                        out[n] = (SampleType) x[n * laneCount + lane];
+                }
+            }
+
+            state[group] = z;
+        }
+    }
+
+private:
+    static constexpr int chunkSize = 32;
+    Vec chunk[chunkSize];
+
+    std::vector<Vec, xsimd::aligned_allocator<Vec>> state;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MultiChannelShelfFilter)
+};
+
+#endif // MULTICHANNELSHELFFILTER_H_INCLUDED
@@ -12,60 +12,79 @@ void ToneStage::prepare (double sampleRate, int numChannels)
 {
     fs = (float) sampleRate;
 
-    tone.resize ((size_t) numChannels);
-    lowGain.resize ((size_t) numChannels);
-    highGain.resize ((size_t) numChannels);
-    tFreq.resize ((size_t) numChannels);
+    auto resetSmoothValue = [sampleRate] (SmoothGain& value, float startValue) {
+        value.reset (sampleRate, slewTime);
+        value.setCurrentAndTargetValue (startValue);
+    };
+
+    resetSmoothValue (lowGain, 1.0f);
+    resetSmoothValue (highGain, 1.0f);
+    resetSmoothValue (tFreq, transFreq);
+
+    tone.prepare (numChannels);
+    blockChannels.resize ((size_t) numChannels, nullptr);
+    coefs = MultiChannelShelfFilter::calcCoefs (lowGain.getTargetValue(), highGain.getTargetValue(), tFreq.getTargetValue(), fs);
+}
 
-    for (size_t ch = 0; ch < (size_t) numChannels; ++ch)
-    {
-        auto resetSmoothValue = [sampleRate] (SmoothGain& value, float startValue) {
-            value.reset (sampleRate, slewTime);
-            value.setCurrentAndTargetValue (startValue);
-        };
+void ToneStage::setSampleRate (double sampleRate)
+{
+    if ((float) sampleRate == fs)
+        return;
 
-        resetSmoothValue (lowGain[ch], 1.0f);
-        resetSmoothValue (highGain[ch], 1.0f);
-        resetSmoothValue (tFreq[ch], transFreq);
+    // keep the filter state, but re-compute everything that depends on the sample rate
+    fs = (float) sampleRate;
+    for (auto* value : { &lowGain, &highGain, &tFreq })
+        value->reset (sampleRate, slewTime);
 
-        tone[ch].reset();
-        tone[ch].calcCoefs (lowGain[ch].getTargetValue(), highGain[ch].getTargetValue(), tFreq[ch].getTargetValue(), fs);
-    }
+    coefs = MultiChannelShelfFilter::calcCoefs (lowGain.getTargetValue(), highGain.getTargetValue(), tFreq.getTargetValue(), fs);
 }
 
-void setSmoothValues (std::vector<SmoothGain>& values, float newValue)
+void ToneStage::setCoefficientUpdateStride (int newStride)
 {
-    if (newValue == values[0].getTargetValue())
-        return;
-
-    for (auto& smoothedVal : values)
-        smoothedVal.setTargetValue (newValue);
+    jassert (newStride > 0);
+    coefStride = newStride;
 }
 
-void ToneStage::setLowGain (float lowGainDB) { setSmoothValues (lowGain, Decibels::decibelsToGain (lowGainDB)); }
-void ToneStage::setHighGain (float highGainDB) { setSmoothValues (highGain, Decibels::decibelsToGain (highGainDB)); }
-void ToneStage::setTransFreq (float newTFreq) { setSmoothValues (tFreq, newTFreq); }
+void ToneStage::setLowGain (float lowGainDB) { lowGain.setTargetValue (Decibels::decibelsToGain (lowGainDB)); }
+void ToneStage::setHighGain (float highGainDB) { highGain.setTargetValue (Decibels::decibelsToGain (highGainDB)); }
+void ToneStage::setTransFreq (float newTFreq) { tFreq.setTargetValue (newTFreq); }
 
 void ToneStage::processBlock (AudioBuffer<float>& buffer)
 {
-    const auto numChannels = buffer.getNumChannels();
-    const auto numSamples = buffer.getNumSamples();
+    processChannels (buffer.getArrayOfWritePointers(), buffer.getNumChannels(), buffer.getNumSamples());
+}
+
+void ToneStage::processBlock (dsp::AudioBlock<double>& block)
+{
+    // an AudioBlock doesn't expose its array of channel pointers, so we collect them here
+    const auto numChannels = (int) block.getNumChannels();
+    jassert (numChannels <= (int) blockChannels.size());
+    for (int ch = 0; ch < numChannels; ++ch)
+        blockChannels[(size_t) ch] = block.getChannelPointer ((size_t) ch);
+
+    processChannels (blockChannels.data(), numChannels, (int) block.getNumSamples());
+}
 
-    for (size_t ch = 0; ch < (size_t) numChannels; ++ch)
+template <typename SampleType>
+void ToneStage::processChannels (SampleType* const* data, int numChannels, int numSamples)
+{
+    if (! (lowGain.isSmoothing() || highGain.isSmoothing() || tFreq.isSmoothing()))
     {
-        auto* data = buffer.getWritePointer ((int) ch);
-        if (lowGain[ch].isSmoothing() || highGain[ch].isSmoothing() || tFreq[ch].isSmoothing())
-        {
-            for (int n = 0; n < numSamples; ++n)
-            {
-                tone[ch].calcCoefs (lowGain[ch].getNextValue(), highGain[ch].getNextValue(), tFreq[ch].getNextValue(), fs);
-                data[n] = tone[ch].processSample (data[n]);
-            }
-        }
-        else
-        {
-            tone[ch].processBlock (data, numSamples);
-        }
+        tone.process (data, numChannels, 0, numSamples, coefs, coefs);
+        return;
+    }
+
+    // while smoothing, the coefficients are computed once per stride, and interpolated in between
+    for (int start = 0; start < numSamples; start += coefStride)
+    {
+        const auto samplesToProcess = jmin (coefStride, numSamples - start);
+        const auto nextCoefs = MultiChannelShelfFilter::calcCoefs (lowGain.skip (samplesToProcess),
+                                                                   highGain.skip (samplesToProcess),
+                                                                   tFreq.skip (samplesToProcess),
+                                                                   fs);
+
+        tone.process (data, numChannels, start, samplesToProcess, coefs, nextCoefs);
+        coefs = nextCoefs;
     }
 }
 
@@ -93,12 +112,33 @@ void ToneControl::createParameterLayout (std::vector<std::unique_ptr<RangedAudio
 
 void ToneControl::prepare (double sampleRate, int numChannels)
 {
+    fs = sampleRate;
     toneIn.prepare (sampleRate, numChannels);
     toneOut.prepare (sampleRate, numChannels);
 }
 
+void ToneControl::setCoefficientUpdateStride (int newStride)
+{
+    toneIn.setCoefficientUpdateStride (newStride);
+    toneOut.setCoefficientUpdateStride (newStride);
+}
+
 void ToneControl::processBlockIn (AudioBuffer<float>& buffer)
 {
+    updateToneIn (1);
+    toneIn.processBlock (buffer);
+}
+
+void ToneControl::processBlockIn (dsp::AudioBlock<double>& osBlock, int osFactor)
+{
+    updateToneIn (osFactor);
+    toneIn.processBlock (osBlock);
+}
+
+void ToneControl::updateToneIn (int osFactor)
+{
+    toneIn.setSampleRate (fs * (double) osFactor);
+
     if (static_cast<bool> (onOffParam->load()))
     {
         toneIn.setLowGain (dbScale * bassParam->getCurrentValue());
@@ -110,8 +150,6 @@ void ToneControl::processBlockIn (AudioBuffer<float>& buffer)
         toneIn.setHighGain (0.0f);
     }
     toneIn.setTransFreq (tFreqParam->getCurrentValue());
-
-    toneIn.processBlock (buffer);
 }
 
 void ToneControl::processBlockOut (AudioBuffer<float>& buffer)
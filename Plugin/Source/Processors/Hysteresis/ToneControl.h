@@ -1,23 +1,33 @@
 #ifndef TONECONTROL_H_INCLUDED
 #define TONECONTROL_H_INCLUDED
 
-#include <JuceHeader.h>
+#include "MultiChannelShelfFilter.h"
 
 using SmoothGain = SmoothedValue<float, ValueSmoothingTypes::Multiplicative>;
 
 struct ToneStage
 {
-    std::vector<chowdsp::ShelfFilter<float>> tone;
-    std::vector<SmoothGain> lowGain, highGain, tFreq;
+    MultiChannelShelfFilter tone;
+    MultiChannelShelfFilter::Coefs coefs;
+    SmoothGain lowGain, highGain, tFreq;
     float fs = 44100.0f;
+    int coefStride = 16;
+    std::vector<double*> blockChannels;
 
     ToneStage();
 
     void prepare (double sampleRate, int numChannels);
+    void setSampleRate (double sampleRate);
+    void setCoefficientUpdateStride (int newStride);
     void processBlock (AudioBuffer<float>& buffer);
+    void processBlock (dsp::AudioBlock<double>& block);
     void setLowGain (float lowGainDB);
     void setHighGain (float highGainDB);
     void setTransFreq (float newTFreq);
+
+private:
+    template <typename SampleType>
+    void processChannels (SampleType* const* data, int numChannels, int numSamples);
 };
 
 class ToneControl
@@ -29,10 +39,18 @@ public:
     void prepare (double sampleRate, int numChannels);
     void setDBScale (float newDBScale) { dbScale = newDBScale; };
 
+    /** Sets how often (in samples) the filter coefficients are re-computed while the parameters are changing */
+    void setCoefficientUpdateStride (int newStride);
+
     void processBlockIn (AudioBuffer<float>& buffer);
     void processBlockOut (AudioBuffer<float>& buffer);
 
+    /** Processes the input tone stage on a block that has already been oversampled by osFactor */
+    void processBlockIn (dsp::AudioBlock<double>& osBlock, int osFactor);
+
 private:
+    void updateToneIn (int osFactor);
+
     ToneStage toneIn, toneOut;
 
     std::atomic<float>* onOffParam = nullptr;
@@ -41,6 +59,7 @@ private:
     chowdsp::FloatParameter* tFreqParam = nullptr;
 
     float dbScale = 1.0f;
+    double fs = 44100.0;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ToneControl)
 };
@@ -6,7 +6,8 @@ constexpr float minFreq = 20.0f;
 constexpr float maxFreq = 22000.0f;
 } // namespace
 
-InputFilters::InputFilters (AudioProcessorValueTreeState& vts)
+InputFilters::InputFilters (AudioProcessorValueTreeState& vts, BypassManager& bypassManager, BypassManager& makeupBypassManager) : bypass (bypassManager),
+                                                                                                                               makeupBypass (makeupBypassManager)
 {
     using namespace chowdsp::ParamUtils;
     loadParameterPointer (lowCutParam, vts, "ifilt_low");
@@ -56,60 +57,62 @@ void InputFilters::prepareToPlay (double sampleRate, int samplesPerBlock, int nu
     highCutFilter.prepare (spec);
     makeupDelay.prepare (spec);
 
-    lowCutBuffer.setSize (numChannels, samplesPerBlock);
-    highCutBuffer.setSize (numChannels, samplesPerBlock);
-    makeupBuffer.setSize (numChannels, samplesPerBlock);
+    for (auto& signals : cutSignals)
+    {
+        signals.highCutBuffer.setSize (numChannels, samplesPerBlock);
+        signals.makeupBuffer.setSize (numChannels, samplesPerBlock);
+        signals.makeupActive = false;
+    }
+    wasMakeupActive = false;
 
-    bypass.prepare (samplesPerBlock, numChannels, bypass.toBool (onOffParam));
-    makeupBypass.prepare (samplesPerBlock, numChannels, bypass.toBool (onOffParam));
+    bypass.prepare (bypass.toBool (onOffParam));
+    makeupBypass.prepare (bypass.toBool (onOffParam));
 }
 
-void InputFilters::processBlock (AudioBuffer<float>& buffer)
+void InputFilters::processBlock (AudioBuffer<float>& buffer, int slot)
 {
+    auto& [highCutBuffer, makeupBuffer, makeupActive] = cutSignals[(size_t) slot];
+    makeupActive = false;
     if (! bypass.processBlockIn (buffer, bypass.toBool (onOffParam)))
         return;
 
     lowCutFilter.setCutoff (lowCutParam->getCurrentValue());
     highCutFilter.setCutoff (jmin (highCutParam->getCurrentValue(), fs * 0.48f));
 
-    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
-    {
-        auto* data = buffer.getWritePointer (ch);
-        auto* cutLowSignal = lowCutBuffer.getWritePointer (ch);
-        auto* cutHighSignal = highCutBuffer.getWritePointer (ch);
+    // the cut signals are only needed for the makeup
+    makeupActive = static_cast<bool> (makeupParam->load());
+    auto* const* cutLowSignal = makeupActive ? makeupBuffer.getArrayOfWritePointers() : nullptr;
+    auto* const* cutHighSignal = makeupActive ? highCutBuffer.getArrayOfWritePointers() : nullptr;
 
-        for (int n = 0; n < buffer.getNumSamples(); ++n)
-        {
-            lowCutFilter.processSample ((size_t) ch, data[n], cutLowSignal[n], data[n]);
-            highCutFilter.processSample ((size_t) ch, data[n], data[n], cutHighSignal[n]);
-        }
-    }
+    const auto numChannels = buffer.getNumChannels();
+    const auto numSamples = buffer.getNumSamples();
+    auto* const* data = buffer.getArrayOfWritePointers();
+    lowCutFilter.processBlock (data, cutLowSignal, data, numChannels, numSamples);
+    highCutFilter.processBlock (data, data, cutHighSignal, numChannels, numSamples);
 
     bypass.processBlockOut (buffer, bypass.toBool (onOffParam));
-
-    lowCutFilter.snapToZero();
-    highCutFilter.snapToZero();
 }
 
-void InputFilters::processBlockMakeup (AudioBuffer<float>& buffer)
+void InputFilters::processBlockMakeup (AudioBuffer<float>& buffer, int slot)
 {
+    auto& [highCutBuffer, makeupBuffer, makeupActive] = cutSignals[(size_t) slot];
     if (! makeupBypass.processBlockIn (buffer, bypass.toBool (onOffParam)))
         return;
 
-    if (! static_cast<bool> (makeupParam->load()))
+    if (makeupActive && ! wasMakeupActive)
+        makeupDelay.reset(); // the delay line hasn't been fed while the makeup was off
+    wasMakeupActive = makeupActive;
+
+    if (! makeupActive)
     {
         makeupBypass.processBlockOut (buffer, bypass.toBool (onOffParam));
         return;
     }
 
-    // compile makeup signal
-    makeupBuffer.setSize (buffer.getNumChannels(), buffer.getNumSamples(), false, false, true);
-    dsp::AudioBlock<float> lowCutBlock (lowCutBuffer);
-    dsp::AudioBlock<float> highCutBlock (highCutBuffer);
-    dsp::AudioBlock<float> makeupBlock (makeupBuffer);
-
-    makeupBlock.fill (0.0f);
-    makeupBlock += lowCutBlock;
+    // compile makeup signal (the low cut signal is already in the makeup buffer)
+    const auto numSamples = (size_t) buffer.getNumSamples();
+    auto highCutBlock = dsp::AudioBlock<float> (highCutBuffer).getSubBlock (0, numSamples);
+    auto makeupBlock = dsp::AudioBlock<float> (makeupBuffer).getSubBlock (0, numSamples);
     makeupBlock += highCutBlock;
 
     // delay makeup signal to be in phase with everything else
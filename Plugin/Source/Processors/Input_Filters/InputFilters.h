@@ -7,14 +7,20 @@
 class InputFilters
 {
 public:
-    InputFilters (AudioProcessorValueTreeState& vts);
+    InputFilters (AudioProcessorValueTreeState& vts, BypassManager& bypassManager, BypassManager& makeupBypassManager);
 
     static void createParameterLayout (chowdsp::Parameters& params);
     void prepareToPlay (double sampleRate, int samplesPerBlock, int numChannels);
     void setMakeupDelay (float newDelaySamples) { makeupDelay.setDelay (newDelaySamples); }
 
-    void processBlock (AudioBuffer<float>& buffer);
-    void processBlockMakeup (AudioBuffer<float>& buffer);
+    /**
+     * The signals cut by the filters are kept in one of two slots until the makeup is
+     * applied, so that the makeup can run a block behind when the processing is pipelined.
+     */
+    static constexpr int numSlots = 2;
+
+    void processBlock (AudioBuffer<float>& buffer, int slot = 0);
+    void processBlockMakeup (AudioBuffer<float>& buffer, int slot = 0);
 
 private:
     std::atomic<float>* onOffParam = nullptr;
@@ -27,7 +33,14 @@ private:
     LinkwitzRileyFilter<float> highCutFilter;
     dsp::DelayLine<float, dsp::DelayLineInterpolationTypes::Lagrange3rd> makeupDelay { 1 << 21 };
 
-    AudioBuffer<float> lowCutBuffer, highCutBuffer, makeupBuffer;
+    struct CutSignals
+    {
+        AudioBuffer<float> highCutBuffer, makeupBuffer;
+        bool makeupActive = false;
+    };
+
+    std::array<CutSignals, numSlots> cutSignals;
+    bool wasMakeupActive = false;
     BypassProcessor bypass;
     BypassProcessor makeupBypass;
 
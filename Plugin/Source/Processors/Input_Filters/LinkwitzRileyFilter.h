@@ -2,12 +2,21 @@
 #define LINKWITZRILEYFILTER_H_INCLUDED
 
 #include <JuceHeader.h>
-
-/** 4th-order L-R Filter */
+#include <xsimd/xsimd.hpp>
+
+/**
+ * 4th-order L-R Filter
+ *
+ * The block processing API runs groups of channels in parallel,
+ * with each channel in one lane of a SIMD register.
+ */
 template <typename SampleType>
 class LinkwitzRileyFilter
 {
 public:
+    using Vec = xsimd::batch<SampleType>;
+    static constexpr auto laneCount = (int) Vec::size;
+
     LinkwitzRileyFilter()
     {
         update();
@@ -28,6 +37,7 @@ public:
         jassert (spec.numChannels > 0);
 
         state.resize (spec.numChannels, {});
+        vecState.resize (chowdsp::Math::ceiling_divide ((size_t) spec.numChannels, (size_t) laneCount));
 
         sampleRate = spec.sampleRate;
         update();
@@ -39,6 +49,9 @@ public:
     {
         for (auto& s : state)
             std::fill (s.begin(), s.end(), static_cast<SampleType> (0));
+
+        for (auto& s : vecState)
+            std::fill (s.begin(), s.end(), Vec (static_cast<SampleType> (0)));
     }
 
     /** Performs the filter operation on a single sample at a time, and returns both
@@ -46,42 +59,106 @@ public:
     */
     inline void processSample (size_t ch, SampleType x, SampleType& outputLow, SampleType& outputHigh) noexcept
     {
-        auto yH = (x - (R2 + g) * state[ch][0] - state[ch][1]) * h;
+        processSampleInternal (x, state[ch], outputLow, outputHigh);
+    }
+
+    /**
+     * Processes a block of multichannel audio. The outputs may point to the
+     * same memory as the input, or either output may be nullptr if it is not needed.
+     *
+     * Note that this uses a separate filter state from processSample()!
+     */
+    void processBlock (const SampleType* const* input, SampleType* const* outputLow, SampleType* const* outputHigh, int numChannels, int numSamples) noexcept
+    {
+        constexpr int chunkSize = 32;
+        Vec xVec[chunkSize], lowVec[chunkSize], highVec[chunkSize];
+
+        for (size_t group = 0; group < vecState.size(); ++group)
+        {
+            const auto startChannel = (int) group * laneCount;
+            const auto channelsInGroup = jmin (laneCount, numChannels - startChannel);
+
+            for (int start = 0; start < numSamples; start += chunkSize)
+            {
+                const auto samplesToProcess = jmin (chunkSize, numSamples - start);
+
+                auto* x = reinterpret_cast<SampleType*> (xVec);
+                for (int lane = 0; lane < laneCount; ++lane)
+                {
+                    if (lane >= channelsInGroup)
+                    {
+                        for (int n = 0; n < samplesToProcess; ++n)
+                            x[n * laneCount + lane] = (SampleType) 0;
+                        continue;
+                    }
+
+                    const auto* in = input[startChannel + lane] + start;
+                    for (int n = 0; n < samplesToProcess; ++n)
+                        x[n * laneCount + lane] = in[n];
+                }
+
+                for (int n = 0; n < samplesToProcess; ++n)
+                    processSampleInternal (xVec[n], vecState[group], lowVec[n], highVec[n]);
+
+                deinterleave (lowVec, outputLow, startChannel, channelsInGroup, start, samplesToProcess);
+                deinterleave (highVec, outputHigh, startChannel, channelsInGroup, start, samplesToProcess);
+            }
+        }
+    }
+
+    /** Ensure that the state variables are rounded to zero if the state
+    variables are denormals. This is only needed if you are doing
+    sample by sample processing.
+    */
+    inline void snapToZero() noexcept
+    {
+        for (auto& s : state)
+            for (auto element : s)
+                juce::dsp::util::snapToZero (element);
+    }
+
+private:
+    template <typename T>
+    inline void processSampleInternal (T x, std::array<T, 4>& s, T& outputLow, T& outputHigh) const noexcept
+    {
+        auto yH = (x - (R2 + g) * s[0] - s[1]) * h;
 
         auto tB = g * yH;
-        auto yB = tB + state[ch][0];
-        state[ch][0] = tB + yB;
+        auto yB = tB + s[0];
+        s[0] = tB + yB;
 
         auto tL = g * yB;
-        auto yL = tL + state[ch][1];
-        state[ch][1] = tL + yL;
+        auto yL = tL + s[1];
+        s[1] = tL + yL;
 
-        auto yH2 = (yL - (R2 + g) * state[ch][2] - state[ch][3]) * h;
+        auto yH2 = (yL - (R2 + g) * s[2] - s[3]) * h;
 
         auto tB2 = g * yH2;
-        auto yB2 = tB2 + state[ch][2];
-        state[ch][2] = tB2 + yB2;
+        auto yB2 = tB2 + s[2];
+        s[2] = tB2 + yB2;
 
         auto tL2 = g * yB2;
-        auto yL2 = tL2 + state[ch][3];
-        state[ch][3] = tL2 + yL2;
+        auto yL2 = tL2 + s[3];
+        s[3] = tL2 + yL2;
 
         outputLow = yL2;
         outputHigh = yL - R2 * yB + yH - yL2;
     }
 
-    /** Ensure that the state variables are rounded to zero if the state
-    variables are denormals. This is only needed if you are doing
-    sample by sample processing.
-    */
-    inline void snapToZero() noexcept
+    static void deinterleave (const Vec* source, SampleType* const* dest, int startChannel, int numChannels, int startSample, int numSamples) noexcept
     {
-        for (auto& s : state)
-            for (auto element : s)
-                juce::dsp::util::snapToZero (element);
+        if (dest == nullptr)
+            return;
+
+        const auto* src = reinterpret_cast<const SampleType*> (source);
+        for (int lane = 0; lane < numChannels; ++lane)
+        {
+            auto* out = dest[startChannel + lane] + startSample;
+            for (int n = 0; n < numSamples; ++n)
+                out[n] = src[n * laneCount + lane];
+        }
     }
 
-private:
     void update()
     {
         g = (SampleType) std::tan (MathConstants<double>::pi * cutoffFrequency / sampleRate);
@@ -91,6 +168,7 @@ private:
     SampleType g, h;
     static constexpr SampleType R2 = static_cast<SampleType> (1.41421356237);
     std::vector<std::array<SampleType, 4>> state;
+    std::vector<std::array<Vec, 4>, xsimd::aligned_allocator<std::array<Vec, 4>>> vecState;
 
     double sampleRate = 44100.0;
     SampleType cutoffFrequency = 2000.0;
@@ -0,0 +1,130 @@
+#ifndef LATENCYDELAYLINE_H_INCLUDED
+#define LATENCYDELAYLINE_H_INCLUDED
+
+#include "JuceHeader.h"
+
+/**
+ * Delay line for latency compensation, where the delay stays constant
+ * for (at least) a whole block.
+ *
+ * Integer delays are read straight from the circular buffer. Fractional
+ * delays use 5th-order Lagrange interpolation (same as
+ * chowdsp::DelayLineInterpolationTypes::Lagrange5th), with the
+ * interpolation weights computed once whenever the delay changes.
+ */
+class LatencyDelayLine
+{
+public:
+    explicit LatencyDelayLine (int maximumDelayInSamples) : maxDelay (maximumDelayInSamples) {}
+
+    void prepare (const dsp::ProcessSpec& spec)
+    {
+        const auto bufferSize = nextPowerOfTwo (maxDelay + (int) spec.maximumBlockSize + numTaps);
+        mask = bufferSize - 1;
+        buffer.setSize ((int) spec.numChannels, bufferSize);
+
+        writePos.resize (spec.numChannels);
+        readPos.resize (spec.numChannels);
+        reset();
+    }
+
+    void reset()
+    {
+        buffer.clear();
+        std::fill (writePos.begin(), writePos.end(), 0);
+        std::fill (readPos.begin(), readPos.end(), 0);
+    }
+
+    void setDelay (float newDelayInSamples)
+    {
+        jassert (isPositiveAndNotGreaterThan (newDelayInSamples, (float) maxDelay));
+        newDelayInSamples = jlimit (0.0f, (float) maxDelay, newDelayInSamples);
+        if (newDelayInSamples == delay)
+            return;
+
+        delay = newDelayInSamples;
+        delayInt = (int) delay;
+        const auto delayFrac = delay - (float) delayInt;
+        isInteger = delayFrac == 0.0f;
+        if (isInteger)
+            return;
+
+        // centre the interpolation points around the delay (if possible)
+        auto u = delayFrac;
+        if (delayInt >= 2)
+        {
+            delayInt -= 2;
+            u += 2.0f;
+        }
+
+        const auto d0 = u;
+        const auto d1 = u - 1.0f;
+        const auto d2 = u - 2.0f;
+        const auto d3 = u - 3.0f;
+        const auto d4 = u - 4.0f;
+        const auto d5 = u - 5.0f;
+
+        weights[0] = -d1 * d2 * d3 * d4 * d5 / 120.0f;
+        weights[1] = d0 * d2 * d3 * d4 * d5 / 24.0f;
+        weights[2] = -d0 * d1 * d3 * d4 * d5 / 12.0f;
+        weights[3] = d0 * d1 * d2 * d4 * d5 / 12.0f;
+        weights[4] = -d0 * d1 * d2 * d3 * d5 / 24.0f;
+        weights[5] = d0 * d1 * d2 * d3 * d4 / 120.0f;
+    }
+
+    float getDelay() const noexcept { return delay; }
+
+    /** Clears the numSamples most recently pushed samples (plus the interpolation taps), so they won't be read back */
+    void clearHistory (int numSamples) noexcept
+    {
+        numSamples = jmin (numSamples + numTaps, mask + 1);
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+        {
+            auto* data = buffer.getWritePointer (ch);
+            const auto pos = writePos[(size_t) ch];
+            for (int k = 1; k <= numSamples; ++k)
+                data[(pos - k) & mask] = 0.0f;
+        }
+    }
+
+    inline void pushSample (int channel, float x) noexcept
+    {
+        auto& pos = writePos[(size_t) channel];
+        buffer.getWritePointer (channel)[pos] = x;
+        pos = (pos + 1) & mask;
+    }
+
+    inline float popSample (int channel) noexcept
+    {
+        const auto* data = buffer.getReadPointer (channel);
+        auto& pos = readPos[(size_t) channel];
+        const auto readIndex = pos - delayInt;
+        pos = (pos + 1) & mask;
+
+        if (isInteger)
+            return data[readIndex & mask];
+
+        auto y = 0.0f;
+        for (int k = 0; k < numTaps; ++k)
+            y += weights[k] * data[(readIndex - k) & mask];
+
+        return y;
+    }
+
+private:
+    static constexpr int numTaps = 6;
+
+    const int maxDelay;
+    int mask = 0;
+    AudioBuffer<float> buffer;
+    std::vector<int> writePos, readPos;
+
+    float delay = -1.0f;
+    int delayInt = 0;
+    bool isInteger = true;
+    float weights[numTaps] {};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LatencyDelayLine)
+};
+
+#endif // LATENCYDELAYLINE_H_INCLUDED
@@ -1,6 +1,7 @@
 ﻿#include "LossFilter.h"
 
-LossFilter::LossFilter (AudioProcessorValueTreeState& vts, int order) : order (order)
+LossFilter::LossFilter (AudioProcessorValueTreeState& vts, BypassManager& bypassManager, int order) : order (order),
+                                                                                                    bypass (bypassManager)
 {
     using namespace chowdsp::ParamUtils;
     loadParameterPointer (speed, vts, "speed");
@@ -61,14 +62,14 @@ void LossFilter::prepare (float sampleRate, int samplesPerBlock, int numChannels
     prevGap = *gap;
 
     azimuthProc.prepare (sampleRate, samplesPerBlock);
-    bypass.prepare (samplesPerBlock, numChannels, bypass.toBool (onOff));
+    bypass.prepare (bypass.toBool (onOff));
 }
 
 void LossFilter::calcHeadBumpFilter (float speedIps, float gapMeters, double fs, MultiChannelIIR& filter)
 {
     auto bumpFreq = speedIps * 0.0254f / (gapMeters * 500.0f);
     auto gain = jmax (1.5f * (1000.0f - std::abs (bumpFreq - 100.0f)) / 1000.0f, 1.0f);
-    *filter.state = *dsp::IIR::Coefficients<float>::makePeakFilter (fs, bumpFreq, 2.0f, gain);
+    *filter.state = dsp::IIR::ArrayCoefficients<float>::makePeakFilter (fs, bumpFreq, 2.0f, gain); // no allocation on the audio thread
 }
 
 void LossFilter::calcCoefs (MultiChannelIIR& filter)
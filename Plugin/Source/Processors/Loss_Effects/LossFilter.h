@@ -8,7 +8,7 @@
 class LossFilter
 {
 public:
-    LossFilter (AudioProcessorValueTreeState& vts, int order = 64);
+    LossFilter (AudioProcessorValueTreeState& vts, BypassManager& bypassManager, int order = 64);
     ~LossFilter() {}
 
     static void createParameterLayout (chowdsp::Parameters& params);
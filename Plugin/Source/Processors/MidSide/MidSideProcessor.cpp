@@ -39,16 +39,18 @@ void MidSideProcessor::prepare (double sampleRate, int samplesPerBlock)
 
     curMS = *midSideParam == 1.0f;
     prevMS = curMS;
+    encodedMS.fill (curMS);
 }
 
-void MidSideProcessor::processInput (AudioBuffer<float>& buffer)
+void MidSideProcessor::processInput (AudioBuffer<float>& buffer, int slot)
 {
     if (buffer.getNumChannels() != 2) // needs to be stereo!
         return;
 
     //mid - side encoding logic here
     const auto numSamples = buffer.getNumSamples();
-    if (curMS)
+    encodedMS[(size_t) slot] = curMS.load (std::memory_order_relaxed);
+    if (encodedMS[(size_t) slot])
     {
         buffer.addFrom (0, 0, buffer, 1, 0, numSamples); // make channel 0 = left + right = mid
         buffer.applyGain (1, 0, numSamples, 2.0f); // make channel 1 = 2 * right
@@ -71,7 +73,7 @@ void MidSideProcessor::processInput (AudioBuffer<float>& buffer)
     inBalanceGain[1].process (dsp::ProcessContextReplacing<float> { rightBlock });
 }
 
-void MidSideProcessor::processOutput (AudioBuffer<float>& buffer)
+void MidSideProcessor::processOutput (AudioBuffer<float>& buffer, int slot)
 {
     if (buffer.getNumChannels() != 2) // needs to be stereo!
         return;
@@ -97,9 +99,9 @@ void MidSideProcessor::processOutput (AudioBuffer<float>& buffer)
         outBalanceGain[1].process (dsp::ProcessContextReplacing<float> { rightBlock });
     }
 
-    //mid - side decoding logic here
+    //mid - side decoding logic here (with the same mode as the input was encoded with)
     const auto numSamples = buffer.getNumSamples();
-    if (curMS)
+    if (encodedMS[(size_t) slot])
     {
         buffer.applyGain (Decibels::decibelsToGain (3.0f)); // undo -3 dB Normalization
 
@@ -121,8 +123,8 @@ void MidSideProcessor::processOutput (AudioBuffer<float>& buffer)
             fadeSmooth.setTargetValue (1.0f);
 
             // reset curMS at the "bottom" of the fade
-            curMS = *midSideParam == 1.0f;
-            prevMS = curMS;
+            prevMS = *midSideParam == 1.0f;
+            curMS.store (prevMS, std::memory_order_relaxed);
         }
     }
 }
@@ -11,16 +11,23 @@ public:
 
     void prepare (double sampleRate, int samplesPerBlock);
 
-    void processInput (AudioBuffer<float>& buffer);
-    void processOutput (AudioBuffer<float>& buffer);
+    /**
+     * The mid/side mode used to encode the input is kept in one of two slots until the
+     * output is decoded, so that the output can run a block behind when the processing is pipelined.
+     */
+    static constexpr int numSlots = 2;
+
+    void processInput (AudioBuffer<float>& buffer, int slot = 0);
+    void processOutput (AudioBuffer<float>& buffer, int slot = 0);
 
 private:
     std::atomic<float>* midSideParam = nullptr; // parameter handle
     chowdsp::FloatParameter* balanceParam = nullptr;
     std::atomic<float>* makeupParam = nullptr;
 
-    bool curMS = false;
+    std::atomic<bool> curMS { false }; // set by the output processing, read by the input processing
     bool prevMS = false;
+    std::array<bool, numSlots> encodedMS {};
 
     SmoothedValue<float, ValueSmoothingTypes::Linear> fadeSmooth;
 
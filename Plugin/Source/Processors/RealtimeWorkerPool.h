@@ -0,0 +1,237 @@
+#ifndef REALTIMEWORKERPOOL_H_INCLUDED
+#define REALTIMEWORKERPOOL_H_INCLUDED
+
+#include <JuceHeader.h>
+
+#if JUCE_INTEL
+#include <immintrin.h>
+#endif
+
+/**
+ * A small pool of worker threads, for splitting up the processing of a block
+ * (e.g. into groups of channels, or into pipeline stages).
+ *
+ * The audio thread forks a job with parallelFor(), does its own share of the
+ * tasks, and then joins the workers. The tasks are split up statically, and
+ * each worker has its own start/claim/done counters, so the fork/join doesn't
+ * need any locks. If a worker hasn't claimed its share by the time the audio
+ * thread is done with its own, the audio thread claims it and does the work
+ * itself, so a worker that is slow to wake up can't hold up the audio thread.
+ *
+ * The workers run at realtime audio priority. After each job, they stay parked
+ * (spinning, without any system calls) for about one callback period, waiting
+ * for the next job, before going to sleep. Waking up a sleeping worker is the
+ * only time the audio thread has to make a system call.
+ */
+class RealtimeWorkerPool
+{
+public:
+    explicit RealtimeWorkerPool (const String& workerThreadName) : threadName (workerThreadName) {}
+    ~RealtimeWorkerPool() { stop(); }
+
+    /** Starts the worker threads. Must not be called while processing! */
+    void start (int numWorkers)
+    {
+        stop();
+        for (int i = 0; i < numWorkers; ++i)
+        {
+            workers.push_back (std::make_unique<Worker> (*this, threadName, i + 1));
+            workers.back()->startThread (Thread::realtimeAudioPriority);
+        }
+    }
+
+    /** Stops the worker threads. Must not be called while processing! */
+    void stop()
+    {
+        for (auto& worker : workers)
+            worker->signalThreadShouldExit();
+
+        for (auto& worker : workers)
+        {
+            worker->wakeUp.signal();
+            worker->stopThread (1000);
+        }
+
+        workers.clear();
+    }
+
+    int getNumWorkers() const noexcept { return (int) workers.size(); }
+
+    /** Sets how long the workers stay parked after each job, before going to sleep (usually one callback period) */
+    void setParkTime (double seconds) noexcept
+    {
+        parkTicks.store (Time::secondsToHighResolutionTicks (jlimit (0.0, maxParkTimeSeconds, seconds)));
+    }
+
+    /** Returns true if called from one of the worker threads (of any pool) */
+    static bool isWorkerThread() noexcept { return isWorker(); }
+
+    /**
+     * Audio thread: calls task (i) for each i in [0, numTasks), spread across the
+     * worker threads and the calling thread, and returns once all the tasks are done.
+     * Task i runs on participant (i % numParticipants), where participant 0 is the
+     * calling thread, unless that participant hasn't started by the time the calling
+     * thread is done with its own tasks, in which case the calling thread runs it.
+     */
+    template <typename TaskFunc>
+    void parallelFor (int numTasks, TaskFunc& task)
+    {
+        numParticipants = jmin (getNumWorkers() + 1, numTasks);
+        if (numParticipants < 2)
+        {
+            for (int i = 0; i < numTasks; ++i)
+                task (i);
+            return;
+        }
+
+        jobContext = &task;
+        jobFunc = [] (void* context, int taskIndex) { (*static_cast<TaskFunc*> (context)) (taskIndex); };
+        jobNumTasks = numTasks;
+        ++jobGeneration;
+
+        // fork
+        for (int i = 0; i < numParticipants - 1; ++i)
+        {
+            auto& worker = *workers[(size_t) i];
+            worker.startedGeneration.store (jobGeneration);
+            if (worker.isSleeping.load())
+                worker.wakeUp.signal();
+        }
+
+        runTasks (0);
+
+        // join
+        for (int i = 0; i < numParticipants - 1; ++i)
+        {
+            auto& worker = *workers[(size_t) i];
+            if (worker.claimJob (jobGeneration))
+            {
+                runTasks (i + 1); // the worker hasn't woken up yet, so don't wait for it
+                continue;
+            }
+
+            while (worker.doneGeneration.load (std::memory_order_acquire) != jobGeneration)
+                pause();
+        }
+    }
+
+private:
+    static bool& isWorker() noexcept
+    {
+        thread_local bool isWorkerThread = false;
+        return isWorkerThread;
+    }
+
+    static inline void pause() noexcept
+    {
+#if JUCE_INTEL
+        _mm_pause();
+#elif JUCE_ARM && defined(__aarch64__)
+        asm volatile ("yield");
+#endif
+    }
+
+    void runTasks (int participant)
+    {
+        for (int i = participant; i < jobNumTasks; i += numParticipants)
+            jobFunc (jobContext, i);
+    }
+
+    struct Worker : Thread
+    {
+        Worker (RealtimeWorkerPool& p, const String& name, int participantIndex) : Thread (name),
+                                                                                   pool (p),
+                                                                                   participant (participantIndex)
+        {
+        }
+
+        void run() override
+        {
+            FloatVectorOperations::disableDenormalisedNumberSupport();
+            isWorker() = true;
+
+            uint64 lastGeneration = 0;
+            bool shouldPark = false;
+            while (! threadShouldExit())
+            {
+                // only park if we've just finished a job, otherwise go straight back to sleep
+                shouldPark = std::exchange (shouldPark, false) && parkUntilJob (lastGeneration);
+                if (! shouldPark && ! sleepUntilJob (lastGeneration))
+                    continue;
+
+                lastGeneration = startedGeneration.load (std::memory_order_acquire);
+                if (claimJob (lastGeneration)) // otherwise the audio thread got there first
+                {
+                    pool.runTasks (participant);
+                    doneGeneration.store (lastGeneration, std::memory_order_release);
+                }
+                shouldPark = true;
+            }
+        }
+
+        /** Claims this worker's share of the job, either for the worker or for the audio thread. Returns false if it was already claimed. */
+        bool claimJob (uint64 generation) noexcept
+        {
+            auto claimed = claimedGeneration.load();
+            return claimed < generation && claimedGeneration.compare_exchange_strong (claimed, generation);
+        }
+
+        /** Spins for up to the pool's park time, in case the next job is coming soon. Returns true if a new job was started. */
+        bool parkUntilJob (uint64 lastGeneration) const noexcept
+        {
+            const auto parkEnd = Time::getHighResolutionTicks() + pool.parkTicks.load (std::memory_order_relaxed);
+            for (int i = 0;; ++i)
+            {
+                if (startedGeneration.load (std::memory_order_acquire) != lastGeneration)
+                    return true;
+
+                // checking the time is a bit more expensive than checking for a job, so don't do it every time
+                if (i % 64 == 0 && Time::getHighResolutionTicks() >= parkEnd)
+                    return false;
+
+                pause();
+            }
+        }
+
+        /** Sleeps until the next job is started (or a timeout). Returns true if a new job was started. */
+        bool sleepUntilJob (uint64 lastGeneration)
+        {
+            // The audio thread sets startedGeneration and then checks isSleeping,
+            // and we do the opposite here, so one of us is guaranteed to see the other.
+            isSleeping.store (true);
+            if (startedGeneration.load() == lastGeneration)
+                wakeUp.wait (100);
+            isSleeping.store (false);
+
+            return startedGeneration.load (std::memory_order_acquire) != lastGeneration;
+        }
+
+        RealtimeWorkerPool& pool;
+        const int participant;
+
+        std::atomic<uint64> startedGeneration { 0 };
+        std::atomic<uint64> claimedGeneration { 0 };
+        std::atomic<uint64> doneGeneration { 0 };
+        std::atomic<bool> isSleeping { false };
+        WaitableEvent wakeUp;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Worker)
+    };
+
+    static constexpr double maxParkTimeSeconds = 0.05;
+
+    const String threadName;
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<int64> parkTicks { Time::secondsToHighResolutionTicks (0.001) };
+
+    // the current job, only written by the audio thread before the fork
+    void* jobContext = nullptr;
+    void (*jobFunc) (void*, int) = nullptr;
+    int jobNumTasks = 0;
+    int numParticipants = 1;
+    uint64 jobGeneration = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RealtimeWorkerPool)
+};
+
+#endif // REALTIMEWORKERPOOL_H_INCLUDED
@@ -0,0 +1,200 @@
+#ifndef STAGEPROFILER_H_INCLUDED
+#define STAGEPROFILER_H_INCLUDED
+
+#include <JuceHeader.h>
+
+#ifndef CHOWTAPE_PROFILER
+#define CHOWTAPE_PROFILER 0
+#endif
+
+#if CHOWTAPE_PROFILER && JUCE_INTEL
+#if JUCE_MSVC
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
+
+/**
+ * Per-stage profiler for the plugin's processing chain.
+ *
+ * The profiler is only active in builds with CHOWTAPE_PROFILER enabled
+ * (cmake -DCHOWTAPE_PROFILER=ON), otherwise the probes just call through
+ * to the processing stage.
+ *
+ * On the audio thread, the cycles spent in each stage are counted for the
+ * current block (excluding any nested stages), and pushed into a lock-free
+ * FIFO at the end of the block. The frames are then collected into running
+ * statistics on the message thread.
+ */
+class StageProfiler : private Timer
+{
+public:
+    enum Stage
+    {
+        InputGain = 0,
+        InputFilters,
+        MidSide,
+        Tone,
+        Compression,
+        Hysteresis,
+        Chew,
+        Degrade,
+        WowFlutter,
+        Loss,
+        Output,
+        NumStages,
+    };
+
+    static constexpr bool isEnabled() noexcept { return CHOWTAPE_PROFILER; }
+
+    StageProfiler()
+    {
+        if (isEnabled())
+            startTimerHz (10);
+    }
+
+    ~StageProfiler() override { stopTimer(); }
+
+    static String getStageName (int stage)
+    {
+        static const StringArray stageNames { "Input Gain", "Input Filters", "Mid/Side", "Tone", "Compression", "Hysteresis", "Chew", "Degrade", "Wow/Flutter", "Loss", "Output" };
+        return stageNames[stage];
+    }
+
+    /** Returns the CPU timestamp counter (or the closest thing available) */
+    static inline uint64 getCycleCount() noexcept
+    {
+#if CHOWTAPE_PROFILER && JUCE_INTEL
+        return (uint64) __rdtsc();
+#elif CHOWTAPE_PROFILER && JUCE_ARM && defined(__aarch64__)
+        uint64 ticks;
+        asm volatile ("mrs %0, cntvct_el0"
+                      : "=r"(ticks));
+        return ticks;
+#else
+        return (uint64) Time::getHighResolutionTicks();
+#endif
+    }
+
+    /** Audio thread: call at the start of each block */
+    void beginBlock (int numSamples) noexcept
+    {
+        if constexpr (isEnabled())
+        {
+            current = {};
+            current.numSamples = numSamples;
+            nestedCycles = 0;
+        }
+    }
+
+    /** Audio thread: runs one stage of the processing chain, and counts the cycles it took */
+    template <typename StageFunc>
+    void probe (Stage stage, StageFunc&& stageFunc)
+    {
+        if constexpr (isEnabled())
+        {
+            const auto outerNestedCycles = std::exchange (nestedCycles, (uint64) 0);
+            const auto start = getCycleCount();
+            stageFunc();
+            const auto elapsed = getCycleCount() - start;
+
+            current.cycles[(size_t) stage] += elapsed - nestedCycles;
+            nestedCycles = outerNestedCycles + elapsed;
+        }
+        else
+        {
+            stageFunc();
+        }
+    }
+
+    /** Audio thread: call at the end of each block. If the FIFO is full, the block is dropped. */
+    void endBlock() noexcept
+    {
+        if constexpr (isEnabled())
+        {
+            const auto scope = fifo.write (1);
+            if (scope.blockSize1 > 0)
+                frames[(size_t) scope.startIndex1] = current;
+            else
+                numDroppedBlocks.fetch_add (1, std::memory_order_relaxed);
+        }
+    }
+
+    struct Stats
+    {
+        std::array<uint64, NumStages> totalCycles {};
+        std::array<uint64, NumStages> maxBlockCycles {};
+        uint64 totalSamples = 0;
+        uint64 numBlocks = 0;
+    };
+
+    /** Reads any new blocks from the FIFO into the running statistics. Should only be called from one (non-audio) thread. */
+    void collect() noexcept
+    {
+        const auto scope = fifo.read (fifo.getNumReady());
+        scope.forEach ([this] (int index) {
+            const auto& frame = frames[(size_t) index];
+            for (size_t i = 0; i < (size_t) NumStages; ++i)
+            {
+                stats.totalCycles[i] += frame.cycles[i];
+                stats.maxBlockCycles[i] = jmax (stats.maxBlockCycles[i], frame.cycles[i]);
+            }
+
+            stats.totalSamples += (uint64) frame.numSamples;
+            stats.numBlocks++;
+        });
+    }
+
+    const Stats& getStats() const noexcept { return stats; }
+    void resetStats() noexcept { stats = {}; }
+
+    /** Returns a readable summary of the statistics collected so far */
+    String getSummary() const
+    {
+        if (! isEnabled())
+            return "Profiling is not enabled in this build";
+
+        const auto totalCycles = (double) std::accumulate (stats.totalCycles.begin(), stats.totalCycles.end(), (uint64) 0);
+        const auto numSamples = (double) jmax (stats.totalSamples, (uint64) 1);
+
+        String summary;
+        summary << "DSP profile: " << String ((int64) stats.numBlocks) << " blocks, " << String ((int64) stats.totalSamples) << " samples ("
+                << String ((int64) numDroppedBlocks.load()) << " blocks dropped)" << newLine;
+        for (int i = 0; i < NumStages; ++i)
+        {
+            const auto cycles = (double) stats.totalCycles[(size_t) i];
+            summary << getStageName (i).paddedRight (' ', 16)
+                    << String (100.0 * cycles / jmax (totalCycles, 1.0), 1).paddedLeft (' ', 6) << "%"
+                    << String (cycles / numSamples, 1).paddedLeft (' ', 10) << " cycles/sample"
+                    << String ((int64) stats.maxBlockCycles[(size_t) i]).paddedLeft (' ', 12) << " cycles max/block" << newLine;
+        }
+
+        return summary;
+    }
+
+private:
+    void timerCallback() override { collect(); }
+
+    struct Frame
+    {
+        std::array<uint64, NumStages> cycles {};
+        int numSamples = 0;
+    };
+
+    // audio thread state
+    Frame current;
+    uint64 nestedCycles = 0;
+
+    static constexpr int fifoSize = isEnabled() ? 1024 : 1; // no need for the memory if we're not profiling
+    AbstractFifo fifo { fifoSize };
+    std::array<Frame, fifoSize> frames;
+    std::atomic<uint64> numDroppedBlocks { 0 };
+
+    // message thread state
+    Stats stats;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (StageProfiler)
+};
+
+#endif // STAGEPROFILER_H_INCLUDED
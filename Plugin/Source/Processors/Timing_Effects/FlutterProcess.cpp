@@ -2,12 +2,13 @@
 
 void FlutterProcess::prepare (double sampleRate, int samplesPerBlock, int numChannels)
 {
-    fs = (float) sampleRate;
+    const auto fs = (float) sampleRate;
+    modulator.prepare (sampleRate, samplesPerBlock, numChannels);
 
     depthSlew.resize ((size_t) numChannels);
     for (auto& dSlew : depthSlew)
     {
-        dSlew.reset (sampleRate, 0.05);
+        dSlew.reset (modulator.getControlRate(), 0.05);
         dSlew.setCurrentAndTargetValue (depthSlewMin);
     }
 
@@ -20,7 +21,8 @@ void FlutterProcess::prepare (double sampleRate, int samplesPerBlock, int numCha
     amp3 = -99.0f * 1000.0f / fs;
     dcOffset = 350.0f * 1000.0f / fs;
 
-    flutterBuffer.setSize (numChannels, samplesPerBlock);
+    sharedModulation.prepare (modulator.getMaxNumControlFrames (samplesPerBlock));
+    sharedFlutterPtrs.resize ((size_t) numChannels);
 }
 
 void FlutterProcess::prepareBlock (float curDepth, float flutterFreq, int numSamples, int numChannels)
@@ -28,17 +30,31 @@ void FlutterProcess::prepareBlock (float curDepth, float flutterFreq, int numSam
     for (auto& dSlew : depthSlew)
         dSlew.setTargetValue (jmax (depthSlewMin, curDepth));
 
-    angleDelta1 = MathConstants<float>::twoPi * flutterFreq / fs;
+    angleDelta1 = MathConstants<float>::twoPi * flutterFreq / (float) modulator.getControlRate();
     angleDelta2 = 2.0f * angleDelta1;
     angleDelta3 = 3.0f * angleDelta1;
 
-    flutterBuffer.setSize (numChannels, numSamples, false, false, true);
-    flutterBuffer.clear();
-    flutterPtrs = flutterBuffer.getArrayOfWritePointers();
+    if (! sharedModulation.isSharing())
+    {
+        modulator.process (numSamples, numChannels, [this] (size_t ch, int) { return generateFrame (ch); });
+        flutterPtrs = modulator.getBuffer().getArrayOfReadPointers();
+        return;
+    }
+
+    // the group leader generates the first channel of flutter for the whole mix group
+    if (sharedModulation.beginBlock (modulator.getControlRate(), modulator.getMaxNumControlFrames (numSamples)))
+        modulator.process (numSamples, 1, [this] (size_t, int) { return sharedModulation.push (generateFrame (0)); });
+    else
+        modulator.process (numSamples, 1, [this] (size_t, int) { return sharedModulation.pop(); });
+    sharedModulation.endBlock();
+
+    std::fill (sharedFlutterPtrs.begin(), sharedFlutterPtrs.end(), modulator.getReadPointer (0, 0));
+    flutterPtrs = sharedFlutterPtrs.data();
 }
 
 void FlutterProcess::plotBuffer (foleys::MagicPlotSource* plot)
 {
+    auto flutterBuffer = modulator.getRenderedBlock();
     if (shouldTurnOff())
         flutterBuffer.clear();
 
@@ -1,7 +1,8 @@
 #ifndef FLUTTERPROCESS_H_INCLUDED
 #define FLUTTERPROCESS_H_INCLUDED
 
-#include <JuceHeader.h>
+#include "../../MixGroups/SharedModulationBuffer.h"
+#include "../ControlRateModulator.h"
 
 class FlutterProcess
 {
@@ -10,24 +11,31 @@ public:
 
     void prepare (double sampleRate, int samplesPerBlock, int numChannels);
     void prepareBlock (float curDepth, float flutterFreq, int numSamples, int numChannels);
+
+    /** Shares the flutter through a mix group buffer (or stops sharing if the buffer is nullptr) */
+    void setSharedModulation (SharedModulationBuffer<1>* sharedBuffer, uint32 instanceID) noexcept { sharedModulation.setBuffer (sharedBuffer, instanceID); }
     void plotBuffer (foleys::MagicPlotSource* plot);
 
     inline bool shouldTurnOff() const noexcept { return depthSlew[0].getTargetValue() == depthSlewMin; }
-    inline void updatePhase (size_t ch) noexcept
+
+    inline std::pair<float, float> getLFO (int n, size_t ch) const noexcept
+    {
+        return std::make_pair (flutterPtrs[ch][n], dcOffset);
+    }
+
+private:
+    /** Computes the next control-rate flutter value */
+    inline ControlRateModulator<1>::Frame generateFrame (size_t ch) noexcept
     {
         phase1[ch] += angleDelta1;
         phase2[ch] += angleDelta2;
         phase3[ch] += angleDelta3;
-    }
+        boundPhase (ch);
 
-    inline std::pair<float, float> getLFO (int n, size_t ch) noexcept
-    {
-        updatePhase (ch);
-        flutterPtrs[ch][n] = depthSlew[ch].getNextValue()
-                             * (amp1 * std::cos (phase1[ch] + phaseOff1)
-                                + amp2 * std::cos (phase2[ch] + phaseOff2)
-                                + amp3 * std::cos (phase3[ch] + phaseOff3));
-        return std::make_pair (flutterPtrs[ch][n], dcOffset);
+        return { depthSlew[ch].getNextValue()
+                 * (amp1 * std::cos (phase1[ch] + phaseOff1)
+                    + amp2 * std::cos (phase2[ch] + phaseOff2)
+                    + amp3 * std::cos (phase3[ch] + phaseOff3)) };
     }
 
     inline void boundPhase (size_t ch) noexcept
@@ -36,11 +44,10 @@ public:
             phase1[ch] -= MathConstants<float>::twoPi;
         while (phase2[ch] >= MathConstants<float>::twoPi)
             phase2[ch] -= MathConstants<float>::twoPi;
-        while (phase2[ch] >= MathConstants<float>::twoPi)
-            phase2[ch] -= MathConstants<float>::twoPi;
+        while (phase3[ch] >= MathConstants<float>::twoPi)
+            phase3[ch] -= MathConstants<float>::twoPi;
     }
 
-private:
     std::vector<float> phase1;
     std::vector<float> phase2;
     std::vector<float> phase3;
@@ -59,9 +66,12 @@ private:
     static constexpr float phaseOff2 = 13.0f * MathConstants<float>::pi / 4.0f;
     static constexpr float phaseOff3 = -MathConstants<float>::pi / 10.0f;
 
-    AudioBuffer<float> flutterBuffer;
-    float** flutterPtrs;
-    float fs = 48000.0f;
+    ControlRateModulator<1> modulator;
+    const float* const* flutterPtrs = nullptr;
+
+    // when shared, every channel uses the same (mono) flutter
+    SharedModulationBuffer<1>::Client sharedModulation;
+    std::vector<const float*> sharedFlutterPtrs;
 
     static constexpr float depthSlewMin = 0.001f;
 
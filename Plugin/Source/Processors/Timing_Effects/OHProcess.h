@@ -7,45 +7,53 @@
  * Class to simulate the Ornstein-Uhlenbeck process.
  * Mostly lifted from https://github.com/mhampton/ZetaCarinaeModules
  * under the GPLv3 license.
+ *
+ * The process is only used as a sub-audio modulation source, so it
+ * is expected to be run at the control rate (see ControlRateModulator).
  */
 class OHProcess
 {
 public:
     OHProcess() = default;
 
-    void prepare (double sampleRate, int samplesPerBlock, int numChannels)
+    void prepare (double controlRate, int maxFramesPerBlock, int numChannels)
     {
-        dsp::ProcessSpec spec { sampleRate, (uint32) samplesPerBlock, (uint32) numChannels };
-        dsp::ProcessSpec monoSpec { sampleRate, (uint32) samplesPerBlock, 1 };
-
-        noiseGen.setNoiseType (chowdsp::Noise<float>::Normal);
-        noiseGen.setGainLinear (1.0f / 2.33f);
-        noiseGen.prepare (monoSpec);
+        dsp::ProcessSpec spec { controlRate, (uint32) maxFramesPerBlock, (uint32) numChannels };
 
         lpf.resize ((size_t) numChannels);
         for (auto& filt : lpf)
         {
             filt.prepare (spec);
-            filt.coefficients = dsp::IIR::Coefficients<float>::makeLowPass (sampleRate, 10.0f);
+            filt.coefficients = dsp::IIR::Coefficients<float>::makeLowPass (controlRate, 10.0f);
         }
 
-        noiseBuffer.setSize (1, samplesPerBlock);
+        noiseBuffer.setSize (1, maxFramesPerBlock + 1); // (the noise is generated in pairs)
         rPtr = noiseBuffer.getReadPointer (0);
 
-        sqrtdelta = 1.0f / std::sqrt ((float) sampleRate);
-        T = 1.0f / (float) sampleRate;
+        sqrtdelta = 1.0f / std::sqrt ((float) controlRate);
+        T = 1.0f / (float) controlRate;
 
         y.resize ((size_t) numChannels, 0.0f);
         y[0] = 1.0f;
     }
 
-    void prepareBlock (float amtParam, int numSamples)
+    /** Resets the noise generator with a new seed */
+    void setSeed (int64 seed) { rand.setSeed (seed); }
+
+    void prepareBlock (float amtParam, int numFrames)
     {
-        noiseBuffer.setSize (1, numSamples, false, false, true);
-        noiseBuffer.clear();
+        jassert (numFrames < noiseBuffer.getNumSamples());
 
-        dsp::AudioBlock<float> noiseBlock (noiseBuffer);
-        noiseGen.process (dsp::ProcessContextReplacing<float> (noiseBlock));
+        // normally distributed noise (Box-Muller), from our own (seedable) random generator
+        auto* noise = noiseBuffer.getWritePointer (0);
+        for (int n = 0; n < numFrames; n += 2)
+        {
+            const auto radius = noiseGain * std::sqrt (-2.0f * std::log (1.0f - rand.nextFloat()));
+            const auto angle = MathConstants<float>::twoPi * rand.nextFloat();
+            noise[n] = radius * std::cos (angle);
+            noise[n + 1] = radius * std::sin (angle);
+        }
+        rPtr = noiseBuffer.getReadPointer (0);
 
         amtParam = std::pow (amtParam, 1.25f);
         amt = amtParam;
@@ -61,15 +69,16 @@ public:
     }
 
 private:
-    float sqrtdelta = 1.0f / std::sqrt (48000.0f);
-    float T = 1.0f / 48000.0f;
+    float sqrtdelta = 1.0f / std::sqrt (3000.0f);
+    float T = 1.0f / 3000.0f;
     std::vector<float> y;
 
     float amt = 0.0f;
     float mean = 0.0f;
     float damping = 0.0f;
 
-    chowdsp::Noise<float> noiseGen;
+    static constexpr float noiseGain = 1.0f / 2.33f;
+    Random rand;
     AudioBuffer<float> noiseBuffer;
     const float* rPtr = nullptr;
 
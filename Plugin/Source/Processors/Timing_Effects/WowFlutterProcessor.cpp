@@ -1,7 +1,8 @@
 #include "WowFlutterProcessor.h"
 #include "../../GUI/Visualizers/LightMeter.h"
 
-WowFlutterProcessor::WowFlutterProcessor (AudioProcessorValueTreeState& vts)
+WowFlutterProcessor::WowFlutterProcessor (AudioProcessorValueTreeState& vts, BypassManager& bypassManager) : bypass (bypassManager),
+                                                                                                             instanceID (mixGroupsData->getNewInstanceID())
 {
     using namespace chowdsp::ParamUtils;
     loadParameterPointer (flutterRate, vts, "rate");
@@ -11,6 +12,7 @@ WowFlutterProcessor::WowFlutterProcessor (AudioProcessorValueTreeState& vts)
     loadParameterPointer (wowVariance, vts, "wow_var");
     loadParameterPointer (wowDrift, vts, "wow_drift");
     flutterOnOff = vts.getRawParameterValue ("flutter_onoff");
+    mixGroupParam = vts.getRawParameterValue (MixGroupsConstants::mixGroupParamID);
 }
 
 void WowFlutterProcessor::initialisePlots (foleys::MagicGUIState& magicState)
@@ -38,7 +40,7 @@ void WowFlutterProcessor::prepareToPlay (double sampleRate, int samplesPerBlock,
 {
     fs = (float) sampleRate;
 
-    bypass.prepare (samplesPerBlock, numChannels, bypass.toBool (flutterOnOff));
+    bypass.prepare (bypass.toBool (flutterOnOff));
     wowProcessor.prepare (sampleRate, samplesPerBlock, numChannels);
     flutterProcessor.prepare (sampleRate, samplesPerBlock, numChannels);
 
@@ -60,6 +62,8 @@ void WowFlutterProcessor::processBlock (AudioBuffer<float>& buffer)
     const auto numChannels = buffer.getNumChannels();
     const auto numSamples = buffer.getNumSamples();
 
+    updateSharedModulation();
+
     auto curDepthWow = powf (*wowDepth, 3.0f);
     auto wowFreq = powf (4.5, *wowRate) - 1.0f;
     wowProcessor.prepareBlock (curDepthWow, wowFreq, wowVariance->getCurrentValue(), wowDrift->getCurrentValue(), numSamples, numChannels);
@@ -87,6 +91,22 @@ void WowFlutterProcessor::processBlock (AudioBuffer<float>& buffer)
     flutterProcessor.plotBuffer (flutterPlot);
 }
 
+void WowFlutterProcessor::updateSharedModulation()
+{
+    // the mix group parameter may not exist when this processor is used on its own (e.g. in the stage benchmarks)
+    const auto mixGroup = shareGroupModulation.load() && mixGroupParam != nullptr ? (int) mixGroupParam->load() : 0;
+    if (mixGroup == 0)
+    {
+        wowProcessor.setSharedModulation (nullptr, instanceID);
+        flutterProcessor.setSharedModulation (nullptr, instanceID);
+        return;
+    }
+
+    auto& groupModulation = mixGroupsData->getModulation (mixGroup);
+    wowProcessor.setSharedModulation (&groupModulation.wow, instanceID);
+    flutterProcessor.setSharedModulation (&groupModulation.flutter, instanceID);
+}
+
 void WowFlutterProcessor::processWetBuffer (AudioBuffer<float>& buffer)
 {
     for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
@@ -94,8 +114,8 @@ void WowFlutterProcessor::processWetBuffer (AudioBuffer<float>& buffer)
         auto* x = buffer.getWritePointer (ch);
         for (int n = 0; n < buffer.getNumSamples(); ++n)
         {
-            auto [wowLFO, wowOffset] = wowProcessor.getLFO (n, ch);
-            auto [flutterLFO, flutterOffset] = flutterProcessor.getLFO (n, ch);
+            auto [wowLFO, wowOffset] = wowProcessor.getLFO (n, (size_t) ch);
+            auto [flutterLFO, flutterOffset] = flutterProcessor.getLFO (n, (size_t) ch);
 
             auto newLength = (wowLFO + flutterLFO + flutterOffset + wowOffset) * fs / 1000.0f;
             newLength = jlimit (0.0f, (float) HISTORY_SIZE, newLength);
@@ -104,27 +124,20 @@ void WowFlutterProcessor::processWetBuffer (AudioBuffer<float>& buffer)
             delay.pushSample (ch, x[n]);
             x[n] = delay.popSample (ch);
         }
-
-        wowProcessor.boundPhase (ch);
-        flutterProcessor.boundPhase (ch);
     }
 }
 
 void WowFlutterProcessor::processBypassed (const AudioBuffer<float>& buffer)
 {
+    // the modulation signals keep running at the control rate (see prepareBlock()),
+    // so here we only need to keep the delay line state moving.
     for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
     {
         delay.setDelay (0.0f);
         for (int n = 0; n < buffer.getNumSamples(); ++n)
         {
-            wowProcessor.updatePhase (ch);
-            flutterProcessor.updatePhase (ch);
-
             delay.pushSample (ch, 0.0f);
             delay.popSample (ch);
         }
-
-        wowProcessor.boundPhase (ch);
-        flutterProcessor.boundPhase (ch);
     }
 }
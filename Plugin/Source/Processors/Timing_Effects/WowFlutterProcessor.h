@@ -1,6 +1,7 @@
 #ifndef WOWFLUTTERPROCESSOR_H_INCLUDED
 #define WOWFLUTTERPROCESSOR_H_INCLUDED
 
+#include "../../MixGroups/MixGroupsController.h"
 #include "../BypassProcessor.h"
 #include "../Hysteresis/DCBlocker.h"
 #include "FlutterProcess.h"
@@ -9,7 +10,7 @@
 class WowFlutterProcessor
 {
 public:
-    WowFlutterProcessor (AudioProcessorValueTreeState& vts);
+    WowFlutterProcessor (AudioProcessorValueTreeState& vts, BypassManager& bypassManager);
 
     void initialisePlots (foleys::MagicGUIState& magicState);
     static void createParameterLayout (chowdsp::Parameters& params);
@@ -17,9 +18,16 @@ public:
     void prepareToPlay (double sampleRate, int samplesPerBlock, int numChannels);
     void processBlock (AudioBuffer<float>&);
 
+    /** Sets the seed for the wow drift and variance, which takes effect the next time prepareToPlay() is called */
+    void setSeed (uint64 newSeed) noexcept { wowProcessor.setSeed (newSeed); }
+
+    /** Enables sharing one set of wow/flutter modulation between all the plugins in a mix group */
+    void setGroupModulationSharing (bool shouldShare) noexcept { shareGroupModulation = shouldShare; }
+
 private:
     void processWetBuffer (AudioBuffer<float>& buffer);
     void processBypassed (const AudioBuffer<float>& buffer);
+    void updateSharedModulation();
 
     std::atomic<float>* flutterOnOff = nullptr;
     chowdsp::FloatParameter* flutterRate = nullptr;
@@ -32,6 +40,12 @@ private:
     BypassProcessor bypass;
     float fs = 48000.0f;
 
+    // this needs to outlive the wow and flutter processes, which may be sharing its modulation buffers
+    SharedResourcePointer<MixGroupsSharedData> mixGroupsData;
+    const uint32 instanceID;
+    std::atomic<float>* mixGroupParam = nullptr;
+    std::atomic<bool> shareGroupModulation { false };
+
     WowProcess wowProcessor;
     FlutterProcess flutterProcessor;
     foleys::MagicPlotSource *wowPlot = nullptr, *flutterPlot = nullptr;
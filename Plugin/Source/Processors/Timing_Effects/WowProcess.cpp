@@ -7,21 +7,27 @@ WowProcess::~WowProcess()
 
 void WowProcess::prepare (double sampleRate, int samplesPerBlock, int numChannels)
 {
-    fs = (float) sampleRate;
+    modulator.prepare (sampleRate, samplesPerBlock, numChannels);
+    const auto controlRate = modulator.getControlRate();
 
     depthSlew.resize ((size_t) numChannels);
     for (auto& dSlew : depthSlew)
     {
-        dSlew.reset (sampleRate, 0.05);
+        dSlew.reset (controlRate, 0.05);
         dSlew.setCurrentAndTargetValue (depthSlewMin);
     }
 
     phase.resize ((size_t) numChannels, 0.0f);
 
     amp = 1000.0f * 1000.0f / (float) sampleRate;
-    wowBuffer.setSize (numChannels, samplesPerBlock);
 
-    ohProc.prepare (sampleRate, samplesPerBlock, numChannels);
+    ohProc.prepare (controlRate, modulator.getMaxNumControlFrames (samplesPerBlock), numChannels);
+    ohProc.setSeed ((int64) seed);
+    driftRand.setSeed ((int64) (seed + 1));
+
+    sharedModulation.prepare (modulator.getMaxNumControlFrames (samplesPerBlock));
+    sharedWowPtrs.resize ((size_t) numChannels);
+    sharedDepthPtrs.resize ((size_t) numChannels);
 }
 
 void WowProcess::prepareBlock (float curDepth, float wowFreq, float wowVar, float wowDrift, int numSamples, int numChannels)
@@ -30,17 +36,39 @@ void WowProcess::prepareBlock (float curDepth, float wowFreq, float wowVar, floa
         dSlew.setTargetValue (jmax (depthSlewMin, curDepth));
 
     auto freqAdjust = wowFreq * (1.0f + std::pow (driftRand.nextFloat(), 1.25f) * wowDrift);
-    angleDelta = MathConstants<float>::twoPi * freqAdjust / fs;
+    angleDelta = MathConstants<float>::twoPi * freqAdjust / (float) modulator.getControlRate();
+
+    const auto numFrames = modulator.getMaxNumControlFrames (numSamples);
+    if (! sharedModulation.isSharing())
+    {
+        ohProc.prepareBlock (wowVar, numFrames);
+        modulator.process (numSamples, numChannels, [this] (size_t ch, int frameIdx) { return generateFrame (ch, frameIdx); });
+        wowPtrs = modulator.getBuffer (0).getArrayOfReadPointers();
+        depthPtrs = modulator.getBuffer (1).getArrayOfReadPointers();
+        return;
+    }
 
-    wowBuffer.setSize (numChannels, numSamples, false, false, true);
-    wowBuffer.clear();
-    wowPtrs = wowBuffer.getArrayOfWritePointers();
+    // the group leader generates the first channel of wow for the whole mix group
+    if (sharedModulation.beginBlock (modulator.getControlRate(), numFrames))
+    {
+        ohProc.prepareBlock (wowVar, numFrames);
+        modulator.process (numSamples, 1, [this] (size_t, int frameIdx) { return sharedModulation.push (generateFrame (0, frameIdx)); });
+    }
+    else
+    {
+        modulator.process (numSamples, 1, [this] (size_t, int) { return sharedModulation.pop(); });
+    }
+    sharedModulation.endBlock();
 
-    ohProc.prepareBlock (wowVar, numSamples);
+    std::fill (sharedWowPtrs.begin(), sharedWowPtrs.end(), modulator.getReadPointer (0, 0));
+    std::fill (sharedDepthPtrs.begin(), sharedDepthPtrs.end(), modulator.getReadPointer (1, 0));
+    wowPtrs = sharedWowPtrs.data();
+    depthPtrs = sharedDepthPtrs.data();
 }
 
 void WowProcess::plotBuffer (foleys::MagicPlotSource* plot)
 {
+    auto wowBuffer = modulator.getRenderedBlock (0);
     if (shouldTurnOff())
         wowBuffer.clear();
 
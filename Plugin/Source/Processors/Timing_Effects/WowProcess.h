@@ -1,8 +1,9 @@
 #ifndef WOWPROCESS_H_INCLUDED
 #define WOWPROCESS_H_INCLUDED
 
+#include "../../MixGroups/SharedModulationBuffer.h"
+#include "../ControlRateModulator.h"
 #include "OHProcess.h"
-#include <JuceHeader.h>
 
 class WowProcess
 {
@@ -11,38 +12,50 @@ public:
     ~WowProcess();
 
     void prepare (double sampleRate, int samplesPerBlock, int numChannels);
+
+    /** Sets the seed for the drift and variance, which takes effect the next time prepare() is called */
+    void setSeed (uint64 newSeed) noexcept { seed = newSeed; }
     void prepareBlock (float curDepth, float wowFreq, float wowVar, float wowDrift, int numSamples, int numChannels);
+
+    /** Shares the wow through a mix group buffer (or stops sharing if the buffer is nullptr) */
+    void setSharedModulation (SharedModulationBuffer<2>* sharedBuffer, uint32 instanceID) noexcept { sharedModulation.setBuffer (sharedBuffer, instanceID); }
     void plotBuffer (foleys::MagicPlotSource* plot);
 
     inline bool shouldTurnOff() const noexcept { return depthSlew[0].getTargetValue() == depthSlewMin; }
-    inline void updatePhase (size_t ch) noexcept { phase[ch] += angleDelta; }
 
-    inline std::pair<float, float> getLFO (int n, size_t ch) noexcept
+    inline std::pair<float, float> getLFO (int n, size_t ch) const noexcept
     {
-        updatePhase (ch);
-        auto curDepth = depthSlew[ch].getNextValue() * amp;
-        wowPtrs[ch][n] = curDepth * (std::cos (phase[ch]) + ohProc.process (n, ch));
-        return std::make_pair (wowPtrs[ch][n], curDepth);
+        return std::make_pair (wowPtrs[ch][n], depthPtrs[ch][n]);
     }
 
-    inline void boundPhase (size_t ch) noexcept
+private:
+    /** Computes the next control-rate wow frame: { LFO, depth offset } */
+    inline ControlRateModulator<2>::Frame generateFrame (size_t ch, int frameIdx) noexcept
     {
+        phase[ch] += angleDelta;
         while (phase[ch] >= MathConstants<float>::twoPi)
             phase[ch] -= MathConstants<float>::twoPi;
+
+        auto curDepth = depthSlew[ch].getNextValue() * amp;
+        return { curDepth * (std::cos (phase[ch]) + ohProc.process (frameIdx, ch)), curDepth };
     }
 
-private:
     float angleDelta = 0.0f;
     float amp = 0.0f;
     std::vector<float> phase;
     std::vector<SmoothedValue<float, ValueSmoothingTypes::Multiplicative>> depthSlew;
 
-    AudioBuffer<float> wowBuffer;
-    float** wowPtrs = nullptr;
-    float fs = 44100.0f;
+    ControlRateModulator<2> modulator;
+    const float* const* wowPtrs = nullptr;
+    const float* const* depthPtrs = nullptr;
+
+    // when shared, every channel uses the same (mono) wow
+    SharedModulationBuffer<2>::Client sharedModulation;
+    std::vector<const float*> sharedWowPtrs, sharedDepthPtrs;
 
     OHProcess ohProc;
     Random driftRand;
+    uint64 seed = (uint64) Random::getSystemRandom().nextInt64();
 
     static constexpr float depthSlewMin = 0.001f;
 